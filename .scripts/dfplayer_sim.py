@@ -0,0 +1,454 @@
+#!/usr/bin/env python3
+# DFPlayer Mini protocol simulator for testing the gate audio without the module.
+#
+# Speaks the 10 byte serial protocol (7E FF 06 CMD FB PH PL CKH CKL EF) on a
+# Linux pseudo terminal or on a real serial port. Plays are timed, and the
+# player reports the end of every track twice like the real module does.
+# Replies can be delayed, dropped or corrupted.
+#
+# Typical use:
+#   Point a USB serial adapter at the gate UART (GPIO 16/17) and run
+#       python3 .scripts/dfplayer_sim.py --port /dev/ttyUSB0 --folder 1=20 --folder 2=1
+#   or run without --port to get a pty that another host program can open.
+#
+# Host build:
+#   --run CMD starts CMD with the pty as its last argument ({port} in CMD is
+#   replaced instead if present) and stops when it exits. The native_audio
+#   environment (see host/README.md) builds the gate audio for the host:
+#       pio run -e native_audio
+#       python3 .scripts/dfplayer_sim.py --track-seconds 1 --benchmark 20 \
+#           --run .pio/build/native_audio/program
+#
+# Benchmark:
+#   --benchmark N measures the time from sending "track finished" to
+#   receiving the next play command. N samples are taken, then it prints
+#   min / mean / p95 / max and exits. Put the gate into its playing state so
+#   that every finished track starts the next one. Run it with --drop or
+#   --reply-latency-ms to see how the gate copes with a bad UART.
+#   A play command that arrives while a track is still playing cut that track
+#   short (for example a repeated "track finished" that was taken for a new
+#   one). These are counted as skipped tracks and make the benchmark exit
+#   with 1.
+#
+# Only the python standard library is needed for the pty. --port needs pyserial.
+
+import argparse
+import heapq
+import os
+import random
+import select
+import shlex
+import statistics
+import subprocess
+import sys
+import time
+import tty
+
+FRAME_START = 0x7E
+FRAME_VERSION = 0xFF
+FRAME_LENGTH = 0x06
+FRAME_END = 0xEF
+FRAME_SIZE = 10
+
+# commands
+CMD_NEXT = 0x01
+CMD_PREVIOUS = 0x02
+CMD_PLAY_TRACK = 0x03
+CMD_VOLUME = 0x06
+CMD_EQ = 0x07
+CMD_OUTPUT_DEVICE = 0x09
+CMD_RESET = 0x0C
+CMD_RESUME = 0x0D
+CMD_PAUSE = 0x0E
+CMD_PLAY_FOLDER = 0x0F
+CMD_STOP = 0x16
+
+# notifications
+NOTIFY_CARD_INSERTED = 0x3A
+NOTIFY_CARD_REMOVED = 0x3B
+NOTIFY_SD_FINISHED = 0x3D
+NOTIFY_ONLINE = 0x3F
+NOTIFY_ERROR = 0x40
+NOTIFY_ACK = 0x41
+
+# queries
+QUERY_STATUS = 0x42
+QUERY_SD_FILE_COUNT = 0x48
+QUERY_FOLDER_FILE_COUNT = 0x4E
+
+# error codes sent with NOTIFY_ERROR
+ERROR_CHECKSUM = 4
+ERROR_NOT_FOUND = 6
+
+DEVICE_SD = 2
+STATE_STOPPED = 0
+STATE_PLAYING = 1
+STATE_PAUSED = 2
+
+PLAY_COMMANDS = (CMD_PLAY_TRACK, CMD_PLAY_FOLDER, CMD_NEXT, CMD_PREVIOUS)
+
+
+def checksum(body):
+    """body is VER LEN CMD FB PH PL"""
+    return (0 - sum(body)) & 0xFFFF
+
+
+def build_frame(command, parameter):
+    body = [FRAME_VERSION, FRAME_LENGTH, command, 0x00, (parameter >> 8) & 0xFF, parameter & 0xFF]
+    ck = checksum(body)
+    return bytes([FRAME_START] + body + [(ck >> 8) & 0xFF, ck & 0xFF, FRAME_END])
+
+
+def log(text):
+    print(f"{time.monotonic():12.3f} {text}", flush=True)
+
+
+class PtyPort:
+    def __init__(self):
+        self.master, slave = os.openpty()
+        tty.setraw(slave)
+        self.name = os.ttyname(slave)
+        self.slave = slave  # keep it open so the master does not see EOF
+
+    def fileno(self):
+        return self.master
+
+    def read(self):
+        try:
+            return os.read(self.master, 256)
+        except OSError:
+            return b""
+
+    def write(self, data):
+        os.write(self.master, data)
+
+
+class SerialPort:
+    def __init__(self, device):
+        import serial  # pyserial, only needed for real ports
+        self.port = serial.Serial(device, 9600, timeout=0)
+        self.name = device
+
+    def fileno(self):
+        return self.port.fileno()
+
+    def read(self):
+        return self.port.read(256)
+
+    def write(self, data):
+        self.port.write(data)
+
+
+class Card:
+    """What is on the simulated SD card"""
+
+    def __init__(self, folders, root_files, default_seconds, durations):
+        self.folders = dict(folders)
+        self.root_files = root_files if root_files is not None else sum(self.folders.values())
+        self.default_seconds = default_seconds
+        self.durations = dict(durations)
+
+    def folder_files(self, folder):
+        return self.folders.get(folder)
+
+    def has_track(self, folder, file):
+        if 0 == folder:
+            return 1 <= file <= self.root_files
+        return 1 <= file <= self.folders.get(folder, 0)
+
+    def seconds(self, folder, file):
+        return self.durations.get((folder, file), self.default_seconds)
+
+    def global_index(self, folder, file):
+        """The player reports the end of a folder track with its index on the card"""
+        if 0 == folder:
+            return file
+        return sum(count for number, count in sorted(self.folders.items()) if number < folder) + file
+
+
+class Simulator:
+    def __init__(self, port, card, args):
+        self.port = port
+        self.card = card
+        self.args = args
+        self.rx = bytearray()
+        self.events = []            # heap of (time, sequence, callable)
+        self.sequence = 0
+        self.state = STATE_STOPPED
+        self.track = (0, 0)
+        self.finish_event = None    # sequence number of the pending finish
+        self.remaining = 0.0        # seconds left on a paused track
+        self.play_started = 0.0
+        self.volume = 0
+        self.stats = {"rx": 0, "tx": 0, "dropped": 0, "corrupted": 0, "bad_rx": 0}
+        # benchmark
+        self.finish_sent_at = None
+        self.samples = []
+        self.skipped = 0
+        self.child = None           # host program started with --run
+
+    # -------------------------------------------------------------------------
+    def schedule(self, delay, action):
+        self.sequence += 1
+        heapq.heappush(self.events, (time.monotonic() + delay, self.sequence, action))
+        return self.sequence
+
+    def cancel(self, sequence):
+        self.events = [event for event in self.events if event[1] != sequence]
+        heapq.heapify(self.events)
+
+    def reply_delay(self):
+        return (self.args.reply_latency_ms + random.uniform(0, self.args.jitter_ms)) / 1000.0
+
+    # -------------------------------------------------------------------------
+    def send(self, command, parameter, delay=None):
+        """Send a frame after the reply latency. May be dropped or corrupted"""
+        delay = self.reply_delay() if delay is None else delay
+        self.schedule(delay, lambda: self.transmit(command, parameter))
+
+    def transmit(self, command, parameter):
+        if random.random() < self.args.drop:
+            self.stats["dropped"] += 1
+            log(f"drop  0x{command:02X} {parameter}")
+            return False
+
+        frame = bytearray(build_frame(command, parameter))
+        if random.random() < self.args.corrupt:
+            frame[random.randrange(1, FRAME_SIZE - 1)] ^= 1 << random.randrange(8)
+            self.stats["corrupted"] += 1
+            log(f"bad   0x{command:02X} {parameter}")
+        else:
+            log(f"tx    0x{command:02X} {parameter}")
+
+        self.port.write(bytes(frame))
+        self.stats["tx"] += 1
+        return True
+
+    # -------------------------------------------------------------------------
+    def start_track(self, folder, file):
+        if not self.card.has_track(folder, file):
+            self.send(NOTIFY_ERROR, ERROR_NOT_FOUND)
+            return
+
+        if self.finish_event is not None:
+            self.cancel(self.finish_event)
+
+        self.track = (folder, file)
+        self.state = STATE_PLAYING
+        self.play_started = time.monotonic()
+        self.remaining = self.card.seconds(folder, file)
+        self.finish_event = self.schedule(self.remaining, self.track_finished)
+
+    def track_finished(self):
+        self.finish_event = None
+        self.state = STATE_STOPPED
+        index = self.card.global_index(*self.track)
+
+        # the real module reports every finished track twice
+        self.transmit(NOTIFY_SD_FINISHED, index)
+        self.finish_sent_at = time.monotonic()
+        if self.args.finish_repeat_ms >= 0:
+            self.schedule(self.args.finish_repeat_ms / 1000.0, lambda: self.transmit(NOTIFY_SD_FINISHED, index))
+
+    def stop(self):
+        if self.finish_event is not None:
+            self.cancel(self.finish_event)
+            self.finish_event = None
+        self.state = STATE_STOPPED
+
+    # -------------------------------------------------------------------------
+    def process(self, command, parameter):
+        log(f"rx    0x{command:02X} {parameter}")
+        self.stats["rx"] += 1
+
+        if command in PLAY_COMMANDS and self.finish_sent_at is not None:
+            latency = (time.monotonic() - self.finish_sent_at) * 1000.0
+            self.finish_sent_at = None
+            self.samples.append(latency)
+            log(f"next play {latency:.1f} ms after track end")
+
+        if command in PLAY_COMMANDS and STATE_PLAYING == self.state:
+            self.skipped += 1
+            log(f"skip  track {self.track[0]}/{self.track[1]} was still playing")
+
+        if CMD_PLAY_TRACK == command:
+            self.start_track(0, parameter)
+        elif CMD_PLAY_FOLDER == command:
+            self.start_track(parameter >> 8, parameter & 0xFF)
+        elif CMD_NEXT == command:
+            folder, file = self.track
+            self.start_track(folder, file + 1)
+        elif CMD_PREVIOUS == command:
+            folder, file = self.track
+            self.start_track(folder, max(1, file - 1))
+        elif CMD_PAUSE == command:
+            if STATE_PLAYING == self.state:
+                self.remaining -= time.monotonic() - self.play_started
+                self.stop()
+                self.state = STATE_PAUSED
+        elif CMD_RESUME == command:
+            if STATE_PAUSED == self.state:
+                self.state = STATE_PLAYING
+                self.play_started = time.monotonic()
+                self.finish_event = self.schedule(max(0.0, self.remaining), self.track_finished)
+        elif CMD_STOP == command:
+            self.stop()
+        elif CMD_VOLUME == command:
+            self.volume = parameter
+        elif CMD_RESET == command:
+            self.stop()
+            self.send(NOTIFY_ONLINE, DEVICE_SD, self.args.reset_ms / 1000.0)
+        elif QUERY_STATUS == command:
+            self.send(QUERY_STATUS, (DEVICE_SD << 8) | self.state)
+        elif QUERY_SD_FILE_COUNT == command:
+            self.send(QUERY_SD_FILE_COUNT, self.card.root_files)
+        elif QUERY_FOLDER_FILE_COUNT == command:
+            count = self.card.folder_files(parameter)
+            if count is None:
+                self.send(NOTIFY_ERROR, ERROR_NOT_FOUND)
+            else:
+                self.send(QUERY_FOLDER_FILE_COUNT, count)
+        elif command in (CMD_EQ, CMD_OUTPUT_DEVICE):
+            pass
+        else:
+            log(f"unsupported command 0x{command:02X}")
+
+    def parse(self, data):
+        """Resync on the start byte. Bad frames get an error like the module sends"""
+        self.rx.extend(data)
+
+        while len(self.rx) >= FRAME_SIZE:
+            if FRAME_START != self.rx[0]:
+                del self.rx[0]
+                continue
+
+            frame = self.rx[:FRAME_SIZE]
+            body = list(frame[1:7])
+            received = (frame[7] << 8) | frame[8]
+
+            if (FRAME_END != frame[9]) or (checksum(body) != received):
+                self.stats["bad_rx"] += 1
+                log("rx    bad frame " + frame.hex(" "))
+                self.send(NOTIFY_ERROR, ERROR_CHECKSUM)
+                del self.rx[0]
+                continue
+
+            del self.rx[:FRAME_SIZE]
+            self.process(frame[3], (frame[5] << 8) | frame[6])
+
+    # -------------------------------------------------------------------------
+    def run(self):
+        if self.args.online_ms >= 0:
+            self.send(NOTIFY_ONLINE, DEVICE_SD, self.args.online_ms / 1000.0)
+        if self.args.remove_card_s > 0:
+            self.schedule(self.args.remove_card_s, self.remove_card)
+
+        while True:
+            now = time.monotonic()
+            while self.events and self.events[0][0] <= now:
+                _, _, action = heapq.heappop(self.events)
+                action()
+
+            if self.args.benchmark and len(self.samples) >= self.args.benchmark:
+                break
+
+            if self.child is not None and self.child.poll() is not None:
+                log(f"host program exited with {self.child.returncode}")
+                break
+
+            timeout = max(0.0, self.events[0][0] - time.monotonic()) if self.events else 0.1
+            readable, _, _ = select.select([self.port], [], [], min(timeout, 0.1))
+            if readable:
+                self.parse(self.port.read())
+
+    def remove_card(self):
+        self.stop()
+        self.transmit(NOTIFY_CARD_REMOVED, DEVICE_SD)
+        if self.args.insert_card_s > 0:
+            self.schedule(self.args.insert_card_s, lambda: self.transmit(NOTIFY_CARD_INSERTED, DEVICE_SD))
+
+    def report(self):
+        print(f"frames rx {self.stats['rx']} tx {self.stats['tx']} dropped {self.stats['dropped']} "
+              f"corrupted {self.stats['corrupted']} bad rx {self.stats['bad_rx']} skipped tracks {self.skipped}")
+
+        if not self.samples:
+            print("no track end to next play samples")
+            return
+
+        samples = sorted(self.samples)
+        p95 = samples[min(len(samples) - 1, int(round(0.95 * (len(samples) - 1))))]
+        print(f"track end to next play over {len(samples)} tracks: "
+              f"min {samples[0]:.1f} ms  mean {statistics.mean(samples):.1f} ms  "
+              f"p95 {p95:.1f} ms  max {samples[-1]:.1f} ms")
+
+
+def parse_folder(text):
+    folder, files = text.split("=")
+    return int(folder), int(files)
+
+
+def parse_duration(text):
+    track, seconds = text.split("=")
+    folder, file = track.split("/") if "/" in track else ("0", track)
+    return (int(folder), int(file)), float(seconds)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="DFPlayer Mini protocol simulator")
+    parser.add_argument("--port", help="serial device to use instead of a pty")
+    parser.add_argument("--folder", action="append", type=parse_folder, default=[],
+                        metavar="N=FILES", help="files in folder N (repeat for more folders)")
+    parser.add_argument("--files", type=int, help="files on the card. Default: the sum of the folders")
+    parser.add_argument("--track-seconds", type=float, default=5.0, help="length of every track")
+    parser.add_argument("--duration", action="append", type=parse_duration, default=[],
+                        metavar="[FOLDER/]FILE=SECONDS", help="length of one track")
+    parser.add_argument("--reply-latency-ms", type=float, default=20.0, help="delay before every reply")
+    parser.add_argument("--jitter-ms", type=float, default=0.0, help="random extra reply delay")
+    parser.add_argument("--drop", type=float, default=0.0, help="probability that a frame is not sent")
+    parser.add_argument("--corrupt", type=float, default=0.0, help="probability that a frame gets a bit flipped")
+    parser.add_argument("--finish-repeat-ms", type=float, default=100.0,
+                        help="gap before the second finished notification. -1 sends only one")
+    parser.add_argument("--online-ms", type=float, default=-1, help="send 'online' this long after start. -1 = never")
+    parser.add_argument("--reset-ms", type=float, default=1000.0, help="time to come back after a reset")
+    parser.add_argument("--remove-card-s", type=float, default=0.0, help="pull the card after this many seconds")
+    parser.add_argument("--insert-card-s", type=float, default=0.0, help="put it back this many seconds later")
+    parser.add_argument("--benchmark", type=int, default=0, metavar="N", help="stop after N track end samples")
+    parser.add_argument("--seed", type=int, help="random seed for repeatable fault injection")
+    parser.add_argument("--run", metavar="CMD", help="start this host program on the pty and stop when it exits")
+    args = parser.parse_args()
+
+    if args.seed is not None:
+        random.seed(args.seed)
+
+    folders = args.folder or [(1, 10), (2, 1)]
+    card = Card(folders, args.files, args.track_seconds, args.duration)
+    port = SerialPort(args.port) if args.port else PtyPort()
+
+    print(f"DFPlayer simulator on {port.name}: {card.root_files} files, folders {dict(folders)}", flush=True)
+
+    simulator = Simulator(port, card, args)
+    if args.run:
+        command = shlex.split(args.run)
+        if any("{port}" in arg for arg in command):
+            command = [arg.replace("{port}", port.name) for arg in command]
+        else:
+            command.append(port.name)
+        simulator.child = subprocess.Popen(command)
+
+    try:
+        simulator.run()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if simulator.child is not None and simulator.child.poll() is None:
+            simulator.child.terminate()
+            simulator.child.wait()
+    simulator.report()
+
+    if args.benchmark and (simulator.skipped or len(simulator.samples) < args.benchmark):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
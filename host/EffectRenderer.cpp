@@ -0,0 +1,487 @@
+/*
+ * EffectRenderer.cpp - Renders the effect engine on the host (Linux) so that
+ *                      effects can be tuned and checked without hardware
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   Every effect in the engine is rendered for a set of pixel counts and
+ *   option combinations. The clock is virtual and the seed is fixed so a run
+ *   is repeatable. The frames can be written to golden files or compared
+ *   against them. See host/README.md.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "InputEffectEngine.hpp"
+
+#include <chrono>
+#include <new>
+#include <vector>
+#include <string>
+
+// -----------------------------------------------------------------------------
+// Local Structure and Data Definitions
+// -----------------------------------------------------------------------------
+
+#define RENDER_DEFAULT_FRAMES   500
+#define RENDER_SEED             0x5EED1234
+#define RENDER_STEP_US          1000    // virtual time between calls to Process
+
+struct Options_t
+{
+    bool Mirror;
+    bool Reverse;
+    bool AllLeds;
+    bool WhiteChannel;
+};
+
+struct Result_t
+{
+    uint32_t Frames;
+    double   FramesPerSecond;
+    double   WritesPerFrame;
+    double   AllocationsPerFrame;
+    double   BytesPerFrame;
+};
+
+static const uint32_t DefaultPixelCounts[] = {10, 100, 1000, 4096};
+
+// Frames written by the engine through the stub output manager
+static std::vector <uint8_t>    OutputFrame;
+static uint32_t                 OutputWriteCount = 0;
+
+// Heap use while the engine is running
+static bool     CountAllocations = false;
+static uint64_t AllocationCount  = 0;
+static uint64_t AllocationBytes  = 0;
+
+// -----------------------------------------------------------------------------
+// Heap hooks
+// -----------------------------------------------------------------------------
+void* operator new (size_t Size)
+{
+    if (CountAllocations)
+    {
+        ++AllocationCount;
+        AllocationBytes += Size;
+    }
+
+    void* Response = malloc ( (0 == Size) ? 1 : Size );
+    if (nullptr == Response)
+    {
+        throw std::bad_alloc ();
+    }
+
+    return(Response);
+}  // operator new
+
+void* operator new[] (size_t Size)
+{
+    return( operator new (Size) );
+}  // operator new[]
+
+void operator delete (void* Pointer) noexcept
+{
+    free (Pointer);
+}  // operator delete
+
+void operator delete[] (void* Pointer) noexcept
+{
+    free (Pointer);
+}  // operator delete[]
+
+void operator delete (void* Pointer, size_t) noexcept
+{
+    free (Pointer);
+}  // operator delete
+
+void operator delete[] (void* Pointer, size_t) noexcept
+{
+    free (Pointer);
+}  // operator delete[]
+
+// -----------------------------------------------------------------------------
+// Stand ins for the parts of the managers the engine calls
+// -----------------------------------------------------------------------------
+config_t    config;
+c_OutputMgr OutputMgr;
+c_InputMgr  InputMgr;
+
+c_OutputMgr::c_OutputMgr ()
+{}  // c_OutputMgr
+
+c_OutputMgr::~c_OutputMgr ()
+{}  // ~c_OutputMgr
+
+// -----------------------------------------------------------------------------
+void c_OutputMgr::WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t* pData)
+{
+    // the capture buffer is not the engine's allocation
+    bool WasCounting = CountAllocations;
+    CountAllocations = false;
+
+    if (OutputFrame.size () < (StartChannelId + ChannelCount))
+    {
+        OutputFrame.resize (StartChannelId + ChannelCount, 0);
+    }
+
+    CountAllocations = WasCounting;
+
+    memcpy (&OutputFrame[StartChannelId], pData, ChannelCount);
+    ++OutputWriteCount;
+}  // WriteChannelData
+
+// -----------------------------------------------------------------------------
+// Engines before the frame buffer read their pixels back from the output
+void c_OutputMgr::ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCount, uint8_t* pTargetData)
+{
+    for (uint32_t Index = 0; Index < ChannelCount; ++Index)
+    {
+        uint32_t ChannelId = StartChannelId + Index;
+        pTargetData[Index] = (ChannelId < OutputFrame.size ()) ? OutputFrame[ChannelId] : 0;
+    }
+}  // ReadChannelData
+
+// -----------------------------------------------------------------------------
+void c_OutputMgr::ClearBuffer ()
+{
+    std::fill (OutputFrame.begin (), OutputFrame.end (), 0);
+}  // ClearBuffer
+
+c_InputMgr::c_InputMgr ()
+{}  // c_InputMgr
+
+c_InputMgr::~c_InputMgr ()
+{}  // ~c_InputMgr
+
+// -----------------------------------------------------------------------------
+// Renderer
+// -----------------------------------------------------------------------------
+static String OptionsName (const Options_t & Options)
+{
+    String Response;
+
+    if (Options.Mirror)       {Response += "mirror-";}
+    if (Options.Reverse)      {Response += "reverse-";}
+    if (Options.AllLeds)      {Response += "allleds-";}
+    if (Options.WhiteChannel) {Response += "white-";}
+
+    return( Response.isEmpty () ? String ("base") : Response.substring (0, Response.length () - 1) );
+}  // OptionsName
+
+// -----------------------------------------------------------------------------
+static String GoldenFileName (const String & Directory, const String & EffectName, uint32_t PixelCount, const Options_t & Options)
+{
+    String Name = EffectName;
+
+    for (unsigned int Index = 0; Index < Name.length (); ++Index)
+    {
+        if (' ' == Name[Index])
+        {
+            Name[Index] = '_';
+        }
+    }
+
+    return(Directory + "/" + Name + "_" + String (PixelCount) + "_" + OptionsName (Options) + ".bin");
+}  // GoldenFileName
+
+// -----------------------------------------------------------------------------
+static void GetEffectNames (std::vector <String> & EffectNames)
+{
+    c_InputEffectEngine Engine;
+    DynamicJsonDocument JsonDoc (4096);
+    JsonObject          JsonConfig = JsonDoc.to <JsonObject> ();
+
+    Engine.GetMqttEffectList (JsonConfig);
+
+    JsonArray EffectList = JsonConfig[CN_effect_list];
+    for (const char* EffectName : EffectList)
+    {
+        EffectNames.push_back (String (EffectName));
+    }
+}  // GetEffectNames
+
+// -----------------------------------------------------------------------------
+// Run the engine until FrameCount frames have been sent to the output. A frame
+// is a call to Process that wrote to the output, however many writes it took.
+// Every frame is appended to Frames.
+static void Render (const String & EffectName, uint32_t PixelCount, const Options_t & Options, uint32_t FrameCount, std::vector <uint8_t> & Frames, Result_t & Result)
+{
+    HostUseVirtualClock (true);
+    uint32_t BufferSize = PixelCount * ( (Options.WhiteChannel) ? 4 : 3 );
+    uint32_t FrameTotal = 0;
+
+    // every captured frame is the whole buffer, even when the engine writes
+    // only part of it
+    OutputFrame.assign (BufferSize, 0);
+    OutputWriteCount = 0;
+
+    c_InputEffectEngine Engine (c_InputMgr::e_InputChannelIds::InputPrimaryChannelId,
+                                c_InputMgr::e_InputType::InputType_Effects,
+                                BufferSize);
+
+    DynamicJsonDocument JsonDoc (4096);
+    JsonObject          JsonConfig = JsonDoc.to <JsonObject> ();
+    JsonConfig[CN_currenteffect]      = EffectName;
+    JsonConfig[CN_EffectMirror]       = Options.Mirror;
+    JsonConfig[CN_EffectReverse]      = Options.Reverse;
+    JsonConfig[CN_EffectAllLeds]      = Options.AllLeds;
+    JsonConfig[CN_EffectWhiteChannel] = Options.WhiteChannel;
+    JsonConfig[CN_EffectBrightness]   = 100;
+    JsonConfig["Seed"]                = RENDER_SEED;
+
+    Engine.Begin ();
+    Engine.SetConfig (JsonConfig);
+
+    Frames.clear ();
+    AllocationCount = 0;
+    AllocationBytes = 0;
+    std::chrono::steady_clock::duration ProcessTime (0);
+
+    // a frame is never more than a minute of virtual time away
+    uint64_t MaxSteps = uint64_t (FrameCount) * 60000;
+    for (uint64_t Step = 0; (Step < MaxSteps) && (FrameTotal < FrameCount); ++Step)
+    {
+        uint32_t WritesBefore = OutputWriteCount;
+
+        std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now ();
+        CountAllocations = true;
+        Engine.Process ();
+        CountAllocations = false;
+
+        // only the calls that produced a frame count towards the frame rate
+        if (WritesBefore != OutputWriteCount)
+        {
+            ++FrameTotal;
+            ProcessTime += std::chrono::steady_clock::now () - Start;
+            Frames.insert (Frames.end (), OutputFrame.begin (), OutputFrame.end ());
+        }
+
+        HostAdvanceMicros (RENDER_STEP_US);
+    }
+
+    double Seconds = std::chrono::duration <double> (ProcessTime).count ();
+    Result.Frames              = FrameTotal;
+    Result.FramesPerSecond     = (Seconds > 0) ? (double(FrameTotal) / Seconds) : 0;
+    Result.WritesPerFrame      = (FrameTotal) ? (double(OutputWriteCount) / FrameTotal) : 0;
+    Result.AllocationsPerFrame = (FrameTotal) ? (double(AllocationCount) / FrameTotal) : 0;
+    Result.BytesPerFrame       = (FrameTotal) ? (double(AllocationBytes) / FrameTotal) : 0;
+}  // Render
+
+// -----------------------------------------------------------------------------
+static bool ReadFile (const String & FileName, std::vector <uint8_t> & Data)
+{
+    FILE* File = fopen (FileName.c_str (), "rb");
+
+    if (nullptr == File)
+    {
+        return(false);
+    }
+
+    uint8_t Buffer[4096];
+    size_t  Count;
+    Data.clear ();
+    while (0 != (Count = fread (Buffer, 1, sizeof (Buffer), File)))
+    {
+        Data.insert (Data.end (), Buffer, Buffer + Count);
+    }
+
+    fclose (File);
+    return(true);
+}  // ReadFile
+
+// -----------------------------------------------------------------------------
+static bool WriteFile (const String & FileName, const std::vector <uint8_t> & Data)
+{
+    FILE* File = fopen (FileName.c_str (), "wb");
+
+    if (nullptr == File)
+    {
+        return(false);
+    }
+
+    bool Response = (Data.size () == fwrite (Data.data (), 1, Data.size (), File));
+
+    fclose (File);
+    return(Response);
+}  // WriteFile
+
+// -----------------------------------------------------------------------------
+static String CompareFrames (const std::vector <uint8_t> & Expected, const std::vector <uint8_t> & Actual, uint32_t FrameSize)
+{
+    if (Expected == Actual)
+    {
+        return("ok");
+    }
+
+    size_t Index = 0;
+    while ( (Index < Expected.size ()) && (Index < Actual.size ()) && (Expected[Index] == Actual[Index]) )
+    {
+        ++Index;
+    }
+
+    return(String ("DIFF at frame ") + String (uint32_t (Index / FrameSize)) + " channel " + String (uint32_t (Index % FrameSize)));
+}  // CompareFrames
+
+// -----------------------------------------------------------------------------
+static void Usage (const char* Name)
+{
+    printf ("Usage: %s [options]\n"
+            "  --frames N           frames to render per case (default %d)\n"
+            "  --pixels A,B,...     pixel counts (default 10,100,1000,4096)\n"
+            "  --effect NAME        only render this effect\n"
+            "  --all-combinations   all 16 option combinations instead of each option on its own\n"
+            "  --write DIR          write the frames to golden files in DIR\n"
+            "  --check DIR          compare the frames with the golden files in DIR\n",
+            Name, RENDER_DEFAULT_FRAMES);
+}  // Usage
+
+// -----------------------------------------------------------------------------
+int main (int argc, char** argv)
+{
+    uint32_t                FrameCount      = RENDER_DEFAULT_FRAMES;
+    bool                    AllCombinations = false;
+    String                  OnlyEffect;
+    String                  WriteDirectory;
+    String                  CheckDirectory;
+    std::vector <uint32_t>  PixelCounts (std::begin (DefaultPixelCounts), std::end (DefaultPixelCounts));
+
+    for (int Index = 1; Index < argc; ++Index)
+    {
+        String  Arg   = argv[Index];
+        String  Value = (Index + 1 < argc) ? String (argv[Index + 1]) : String ();
+
+        if (Arg == "--frames")
+        {
+            FrameCount = uint32_t (Value.toInt ());
+            ++Index;
+        }
+        else if (Arg == "--pixels")
+        {
+            PixelCounts.clear ();
+            for (char* Token = strtok (argv[++Index], ","); nullptr != Token; Token = strtok (nullptr, ","))
+            {
+                PixelCounts.push_back (uint32_t (atol (Token)));
+            }
+        }
+        else if (Arg == "--effect")
+        {
+            OnlyEffect = Value;
+            ++Index;
+        }
+        else if (Arg == "--all-combinations")
+        {
+            AllCombinations = true;
+        }
+        else if (Arg == "--write")
+        {
+            WriteDirectory = Value;
+            ++Index;
+        }
+        else if (Arg == "--check")
+        {
+            CheckDirectory = Value;
+            ++Index;
+        }
+        else
+        {
+            Usage (argv[0]);
+            return( (Arg == "--help") ? 0 : 2 );
+        }
+    }
+
+    std::vector <Options_t> OptionSets;
+    if (AllCombinations)
+    {
+        for (uint32_t Bits = 0; Bits < 16; ++Bits)
+        {
+            OptionSets.push_back ({bool(Bits & 1), bool(Bits & 2), bool(Bits & 4), bool(Bits & 8)});
+        }
+    }
+    else
+    {
+        OptionSets.push_back ({false, false, false, false});
+        OptionSets.push_back ({true,  false, false, false});
+        OptionSets.push_back ({false, true,  false, false});
+        OptionSets.push_back ({false, false, true,  false});
+        OptionSets.push_back ({false, false, false, true });
+    }
+
+    std::vector <String> EffectNames;
+    GetEffectNames (EffectNames);
+
+    uint32_t                Failures = 0;
+    std::vector <uint8_t>   Frames;
+    std::vector <uint8_t>   Golden;
+
+    printf ("%-14s %6s %-28s %6s %10s %12s %12s %12s  %s\n", "effect", "pixels", "options", "frames", "fps", "writes/frm", "allocs/frm", "bytes/frm", "golden");
+
+    for (const String & EffectName : EffectNames)
+    {
+        if ( !OnlyEffect.isEmpty () && !OnlyEffect.equalsIgnoreCase (EffectName) )
+        {
+            continue;
+        }
+
+        for (uint32_t PixelCount : PixelCounts)
+        {
+            for (const Options_t & Options : OptionSets)
+            {
+                Result_t    Result;
+                String      GoldenStatus = "-";
+                String      FileName;
+
+                Render (EffectName, PixelCount, Options, FrameCount, Frames, Result);
+
+                if ( !WriteDirectory.isEmpty () )
+                {
+                    FileName     = GoldenFileName (WriteDirectory, EffectName, PixelCount, Options);
+                    GoldenStatus = WriteFile (FileName, Frames) ? "written" : "WRITE FAILED";
+                }
+
+                if ( !CheckDirectory.isEmpty () )
+                {
+                    FileName = GoldenFileName (CheckDirectory, EffectName, PixelCount, Options);
+                    if ( !ReadFile (FileName, Golden) )
+                    {
+                        GoldenStatus = "MISSING";
+                    }
+                    else
+                    {
+                        GoldenStatus = CompareFrames (Golden, Frames, max (uint32_t (1), uint32_t (OutputFrame.size ())));
+                    }
+                }
+
+                bool GoldenFailed = ( !CheckDirectory.isEmpty () && (GoldenStatus != "ok") ) || (GoldenStatus == "WRITE FAILED");
+                if ( (Result.Frames < FrameCount) || GoldenFailed )
+                {
+                    ++Failures;
+                }
+
+                printf ("%-14s %6u %-28s %6u %10.0f %12.1f %12.2f %12.1f  %s\n",
+                        EffectName.c_str (), PixelCount, OptionsName (Options).c_str (),
+                        Result.Frames, Result.FramesPerSecond, Result.WritesPerFrame, Result.AllocationsPerFrame, Result.BytesPerFrame,
+                        GoldenStatus.c_str ());
+            }
+        }
+    }
+
+    if (Failures)
+    {
+        printf ("%u case(s) failed\n", Failures);
+    }
+
+    return( (Failures) ? 1 : 0 );
+}  // main
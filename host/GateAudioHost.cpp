@@ -0,0 +1,184 @@
+/*
+ * GateAudioHost.cpp - Runs the gate audio (c_GateAudio, c_DFPlayerAsync and
+ *                     c_GatePlaylist) on the host (Linux) against a DFPlayer
+ *                     on a tty / pty. Made to be driven by
+ *                     .scripts/dfplayer_sim.py --run
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   The gate state machine is not built. This file stands in for its playing
+ *   state: once the player is installed a track is started and every finished
+ *   track starts the next one (see FsmInputGatePlaying). With --open it stands
+ *   in for the opening / open states instead: one track is asked for right
+ *   away, whether or not the player is there yet, and only the finish events
+ *   start more (see FsmInputGateOpening).
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "GateAudio.hpp"
+
+#define HOST_INSTALL_CHECK_MS   100
+
+extern String HostConfigDirectory;
+
+static bool     Playing        = false;
+static bool     OpenState      = false;
+static uint32_t TracksFinished = 0;
+
+// -----------------------------------------------------------------------------
+static void GetDriverName (String & Name)
+{
+    Name = "GateHost";
+}  // GetDriverName
+
+// -----------------------------------------------------------------------------
+static void AudioEvent (void*, uint8_t Event)
+{
+    switch (Event)
+    {
+        case c_GateAudio::AudioEventTrackFinished:
+        {
+            ++TracksFinished;
+
+            // When audio completes, restart it
+            if (Playing)
+            {
+                GateAudio.PlayCurrentSelection ();
+            }
+            break;
+        }
+
+        case c_GateAudio::AudioEventCardRemoved:
+        {
+            // nothing left to play. Start again once the card is back
+            logcon (F ("Card removed"));
+            Playing = OpenState;
+            break;
+        }
+
+        case c_GateAudio::AudioEventError:
+        {
+            logcon (F ("Player reported an error"));
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    } // switch
+}  // AudioEvent
+
+// -----------------------------------------------------------------------------
+static bool PlayerIsInstalled ()
+{
+    DynamicJsonDocument JsonDoc (2048);
+    JsonObject          JsonStatus = JsonDoc.to <JsonObject> ();
+
+    GateAudio.GetStatus (JsonStatus);
+
+    return( JsonStatus[CN_MP3]["installed"].as <bool> () );
+}  // PlayerIsInstalled
+
+// -----------------------------------------------------------------------------
+int main (int argc, char** argv)
+{
+    const char* Device  = nullptr;
+    uint32_t    Seconds = 0;
+
+    for (int Index = 1; Index < argc; ++Index)
+    {
+        String Arg = argv[Index];
+
+        if ( (Arg == "--data") && (Index + 1 < argc) )
+        {
+            HostConfigDirectory = argv[++Index];
+        }
+        else if ( (Arg == "--seconds") && (Index + 1 < argc) )
+        {
+            Seconds = uint32_t (atol (argv[++Index]));
+        }
+        else if (Arg == "--open")
+        {
+            OpenState = true;
+        }
+        else if ('-' != argv[Index][0])
+        {
+            Device = argv[Index];
+        }
+        else
+        {
+            Device = nullptr;
+            break;
+        }
+    }
+
+    if (nullptr == Device)
+    {
+        printf ("Usage: %s [--data DIR] [--seconds N] [--open] DEVICE\n"
+                "  DEVICE        tty / pty of the DFPlayer (or of dfplayer_sim.py)\n"
+                "  --data DIR    directory that holds the config files (default .)\n"
+                "  --seconds N   stop after N seconds (default: run until killed)\n"
+                "  --open        ask for one track at start up and leave the rest to\n"
+                "                the player events, like the gate opening states\n",
+                argv[0]);
+        return(2);
+    }
+
+    Serial2.SetDevice (Device);
+    GateAudio.RegisterEventHandler (AudioEvent, nullptr);
+    GateAudio.Begin ();
+
+    if (OpenState)
+    {
+        // the gate was opened before the player answered
+        logcon (F ("Gate open. Playing"));
+        Playing = true;
+        GateAudio.PlayCurrentSelection ();
+    }
+
+    uint32_t StartMs            = millis ();
+    uint32_t LastInstallCheckMs = StartMs;
+
+    while ( (0 == Seconds) || ( (millis () - StartMs) < (Seconds * 1000) ) )
+    {
+        GateAudio.Poll ();
+
+        uint32_t now = millis ();
+        if (!Playing && (HOST_INSTALL_CHECK_MS <= (now - LastInstallCheckMs)))
+        {
+            LastInstallCheckMs = now;
+
+            // the user pressed play
+            if ( PlayerIsInstalled () )
+            {
+                logcon (F ("Player installed. Playing"));
+                Playing = true;
+
+                if ( GateAudio.IsIdle () )
+                {
+                    GateAudio.PlayCurrentSelection ();
+                }
+            }
+        }
+
+        delay (1);
+    }
+
+    logcon (String (F ("Tracks finished: ")) + String (TracksFinished));
+
+    return(0);
+}  // main
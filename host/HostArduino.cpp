@@ -0,0 +1,262 @@
+/*
+ * HostArduino.cpp - Host (Linux) implementation of the Arduino core calls
+ *                   declared in host/stubs/Arduino.h
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include "JurasicParkGate.h"
+
+#include <chrono>
+#include <thread>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+HardwareSerial  Serial (0);
+HardwareSerial  Serial1 (1);
+HardwareSerial  Serial2 (2);
+EspClass        ESP;
+
+static bool         UseVirtualClock = false;
+static uint64_t     VirtualClockUs  = 0;
+static std::mt19937 RandomGenerator;
+
+// -----------------------------------------------------------------------------
+static uint64_t NowUs ()
+{
+    if (UseVirtualClock)
+    {
+        return(VirtualClockUs);
+    }
+
+    static const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now ();
+
+    return( uint64_t ( std::chrono::duration_cast <std::chrono::microseconds> (std::chrono::steady_clock::now () - Start).count () ) );
+}  // NowUs
+
+// -----------------------------------------------------------------------------
+void HostUseVirtualClock (bool Enable)
+{
+    UseVirtualClock = Enable;
+    VirtualClockUs  = 0;
+}  // HostUseVirtualClock
+
+// -----------------------------------------------------------------------------
+void HostAdvanceMicros (uint64_t DeltaUs)
+{
+    VirtualClockUs += DeltaUs;
+}  // HostAdvanceMicros
+
+// -----------------------------------------------------------------------------
+unsigned long millis ()
+{
+    return( (unsigned long)(uint32_t (NowUs () / 1000) ) );
+}  // millis
+
+// -----------------------------------------------------------------------------
+unsigned long micros ()
+{
+    return( (unsigned long)(uint32_t (NowUs () ) ) );
+}  // micros
+
+// -----------------------------------------------------------------------------
+int64_t esp_timer_get_time ()
+{
+    return( int64_t ( NowUs () ) );
+}  // esp_timer_get_time
+
+// -----------------------------------------------------------------------------
+void delay (uint32_t DelayMs)
+{
+    delayMicroseconds (DelayMs * 1000);
+}  // delay
+
+// -----------------------------------------------------------------------------
+void delayMicroseconds (uint32_t DelayUs)
+{
+    if (UseVirtualClock)
+    {
+        VirtualClockUs += DelayUs;
+    }
+    else
+    {
+        std::this_thread::sleep_for ( std::chrono::microseconds (DelayUs) );
+    }
+}  // delayMicroseconds
+
+// -----------------------------------------------------------------------------
+void yield ()
+{}  // yield
+
+// -----------------------------------------------------------------------------
+void randomSeed (unsigned long Seed)
+{
+    RandomGenerator.seed (Seed);
+}  // randomSeed
+
+// -----------------------------------------------------------------------------
+long random (long Max)
+{
+    return( (Max <= 0) ? 0 : long(RandomGenerator () % uint32_t (Max) ) );
+}  // random
+
+// -----------------------------------------------------------------------------
+long random (long Min, long Max)
+{
+    return( (Max <= Min) ? Min : Min + random (Max - Min) );
+}  // random
+
+// -----------------------------------------------------------------------------
+uint32_t esp_random ()
+{
+    return( RandomGenerator () );
+}  // esp_random
+
+// -----------------------------------------------------------------------------
+long map (long Value, long InMin, long InMax, long OutMin, long OutMax)
+{
+    return( (InMax == InMin) ? OutMin : (Value - InMin) * (OutMax - OutMin) / (InMax - InMin) + OutMin );
+}  // map
+
+// -----------------------------------------------------------------------------
+size_t Stream::write (const uint8_t* Data, size_t Length)
+{
+    size_t Count = 0;
+
+    while ( (Count < Length) && (1 == write (Data[Count]) ) )
+    {
+        ++Count;
+    }
+
+    return(Count);
+}  // write
+
+// -----------------------------------------------------------------------------
+void HardwareSerial::begin (unsigned long, uint32_t, int8_t, int8_t, bool)
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        if (0 == Port)
+        {
+            fd = STDOUT_FILENO;
+            break;
+        }
+
+        if ( (-1 != fd) || Device.empty () )
+        {
+            break;
+        }
+
+        fd = open (Device.c_str (), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (-1 == fd)
+        {
+            fprintf (stderr, "Could not open serial device '%s'\n", Device.c_str ());
+            break;
+        }
+
+        // the DFPlayer protocol is binary. Do not let the tty layer touch it.
+        struct termios Settings;
+        if (0 == tcgetattr (fd, &Settings))
+        {
+            cfmakeraw (&Settings);
+            cfsetspeed (&Settings, B9600);
+            tcsetattr (fd, TCSANOW, &Settings);
+        }
+    } while (false);
+
+    // DEBUG_END;
+}  // begin
+
+// -----------------------------------------------------------------------------
+void HardwareSerial::end ()
+{
+    if ( (-1 != fd) && (0 != Port) )
+    {
+        close (fd);
+    }
+
+    fd         = -1;
+    PeekedByte = -1;
+}  // end
+
+// -----------------------------------------------------------------------------
+int HardwareSerial::peek ()
+{
+    if ( (-1 == PeekedByte) && (-1 != fd) && (0 != Port) )
+    {
+        uint8_t Data;
+        if (1 == ::read (fd, &Data, 1))
+        {
+            PeekedByte = Data;
+        }
+    }
+
+    return(PeekedByte);
+}  // peek
+
+// -----------------------------------------------------------------------------
+int HardwareSerial::available ()
+{
+    return( (-1 == peek ()) ? 0 : 1 );
+}  // available
+
+// -----------------------------------------------------------------------------
+int HardwareSerial::read ()
+{
+    int Response = peek ();
+
+    PeekedByte = -1;
+
+    return(Response);
+}  // read
+
+// -----------------------------------------------------------------------------
+size_t HardwareSerial::write (const uint8_t* Data, size_t Length)
+{
+    int FileId = (0 == Port) ? STDOUT_FILENO : fd;
+
+    if (-1 == FileId)
+    {
+        return(0);
+    }
+
+    ssize_t Count = ::write (FileId, Data, Length);
+
+    return( (Count < 0) ? 0 : size_t (Count) );
+}  // write
+
+// -----------------------------------------------------------------------------
+// Same format as the firmware (JurasicParkGate.ino)
+void _logcon (String & DriverName, String Message)
+{
+    char Spaces[] = {"       "};
+
+    if ( DriverName.length () < (sizeof (Spaces) - 1) )
+    {
+        Spaces[(sizeof (Spaces) - 1) - DriverName.length ()] = '\0';
+    }
+    else
+    {
+        Spaces[0] = '\0';
+    }
+
+    LOG_PORT.println ("[" + String (Spaces) + DriverName + "] " + Message);
+    LOG_PORT.flush ();
+}  // _logcon
@@ -0,0 +1,102 @@
+/*
+ * HostFileMgr.cpp - Host (Linux) stand in for the config file calls of
+ *                   c_FileMgr. The files live in a local directory.
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "FileMgr.hpp"
+
+// Set by the host program. Takes the place of the LittleFS root
+String HostConfigDirectory = ".";
+
+// -----------------------------------------------------------------------------
+c_FileMgr::c_FileMgr ()
+{}  // c_FileMgr
+
+// -----------------------------------------------------------------------------
+c_FileMgr::~c_FileMgr ()
+{}  // ~c_FileMgr
+
+// -----------------------------------------------------------------------------
+bool c_FileMgr::SaveConfigFile (const String & FileName, JsonDocument & FileData)
+{
+    // DEBUG_START;
+    bool Response = false;
+
+    do  // once
+    {
+        String RawFileData;
+        serializeJson (FileData, RawFileData);
+
+        FILE* File = fopen ( (HostConfigDirectory + FileName).c_str (), "w" );
+        if (nullptr == File)
+        {
+            logcon (String (CN_stars) + CN_Configuration_File_colon + "'" + FileName + F ("' could not be written.") + CN_stars);
+            break;
+        }
+
+        Response = (RawFileData.length () == fwrite (RawFileData.c_str (), 1, RawFileData.length (), File));
+        fclose (File);
+    } while (false);
+
+    // DEBUG_END;
+    return(Response);
+}  // SaveConfigFile
+
+// -----------------------------------------------------------------------------
+bool c_FileMgr::ReadConfigFile (const String & FileName, JsonDocument & FileData)
+{
+    // DEBUG_START;
+    bool GotFileData = false;
+
+    do  // once
+    {
+        FILE* File = fopen ( (HostConfigDirectory + FileName).c_str (), "r" );
+        if (nullptr == File)
+        {
+            logcon (String (CN_stars) + CN_Configuration_File_colon + "'" + FileName + F ("' not found.") + CN_stars);
+            break;
+        }
+
+        String  RawFileData;
+        char    Buffer[256];
+        size_t  Count;
+        while ( 0 != (Count = fread (Buffer, 1, sizeof (Buffer) - 1, File)) )
+        {
+            Buffer[Count] = '\0';
+            RawFileData += Buffer;
+        }
+
+        fclose (File);
+
+        DeserializationError error = deserializeJson (FileData, RawFileData.c_str ());
+        if (error)
+        {
+            logcon (String (CN_Configuration_File_colon) + "'" + FileName + "' " + F ("Deserialzation Error. Error code = ") + error.c_str ());
+            break;
+        }
+
+        GotFileData = true;
+    } while (false);
+
+    // DEBUG_END;
+    return(GotFileData);
+}  // ReadConfigFile
+
+// create a global instance of the File Manager
+c_FileMgr FileMgr;
@@ -0,0 +1,127 @@
+/*
+ * HostWire.cpp - Host (Linux) stand in for Wire with a PCA9685 on the bus.
+ *                The device keeps its registers so that a test can read
+ *                back what the driver sent.
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include <Adafruit_PWMServoDriver.h>
+
+TwoWire         Wire;
+HostPca9685_t   HostPca9685;
+
+static uint8_t  TxAddress      = 0;
+static bool     TxHavePointer  = false;
+static uint8_t  RegisterPointer = 0;
+static uint8_t  RxRemaining    = 0;
+
+// -----------------------------------------------------------------------------
+static void AdvancePointer ()
+{
+    // the device only auto increments when MODE1.AI is set
+    if (HostPca9685.Registers[PCA9685_MODE1] & MODE1_AI)
+    {
+        ++RegisterPointer;
+    }
+}  // AdvancePointer
+
+// -----------------------------------------------------------------------------
+bool TwoWire::begin (int, int, uint32_t)
+{
+    return(true);
+}  // begin
+
+// -----------------------------------------------------------------------------
+bool TwoWire::end ()
+{
+    return(true);
+}  // end
+
+// -----------------------------------------------------------------------------
+void TwoWire::beginTransmission (uint8_t Address)
+{
+    TxAddress     = Address;
+    TxHavePointer = false;
+}  // beginTransmission
+
+// -----------------------------------------------------------------------------
+size_t TwoWire::write (uint8_t Data)
+{
+    if ( (TxAddress == HostPca9685.Address) && HostPca9685.Present)
+    {
+        if (!TxHavePointer)
+        {
+            RegisterPointer = Data;
+            TxHavePointer   = true;
+        }
+        else
+        {
+            HostPca9685.Registers[RegisterPointer] = Data;
+            AdvancePointer ();
+        }
+    }
+
+    return(1);
+}  // write
+
+// -----------------------------------------------------------------------------
+uint8_t TwoWire::endTransmission (bool)
+{
+    uint8_t Response = 2;   // address NACK
+
+    if ( (TxAddress == HostPca9685.Address) && HostPca9685.Present)
+    {
+        // a bare address probe does not change the outputs
+        if (TxHavePointer)
+        {
+            ++HostPca9685.Transactions;
+        }
+
+        Response = 0;
+    }
+
+    return(Response);
+}  // endTransmission
+
+// -----------------------------------------------------------------------------
+uint8_t TwoWire::requestFrom (uint8_t Address, uint8_t Quantity, bool)
+{
+    RxRemaining = ( (Address == HostPca9685.Address) && HostPca9685.Present) ? Quantity : 0;
+
+    return(RxRemaining);
+}  // requestFrom
+
+// -----------------------------------------------------------------------------
+int TwoWire::available ()
+{
+    return(RxRemaining);
+}  // available
+
+// -----------------------------------------------------------------------------
+int TwoWire::read ()
+{
+    int Response = -1;
+
+    if (RxRemaining)
+    {
+        --RxRemaining;
+        Response = HostPca9685.Registers[RegisterPointer];
+        AdvancePointer ();
+    }
+
+    return(Response);
+}  // read
@@ -0,0 +1,386 @@
+/*
+ * HsvConversionTest.cpp - Checks the fixed point rgb2hsv / hsv2rgb of the
+ *                         effect engine against the double versions they
+ *                         replaced and times both
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   Every RGB color is sent through rgb2hsv then hsv2rgb with both versions.
+ *   Every CHSV value is sent through hsv2rgb and compared with the double
+ *   version at the same hue. See host/README.md.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "InputEffectEngine.hpp"
+
+#include <chrono>
+#include <cmath>
+
+// -----------------------------------------------------------------------------
+// Local Structure and Data Definitions
+// -----------------------------------------------------------------------------
+
+// Largest allowed difference, per channel, from the double versions. The
+// double hsv2rgb truncates and the fixed point one rounds, which is most of it
+#define TEST_HSV2RGB_MAX_ERROR      2   // same hue, sat and val
+#define TEST_ROUND_TRIP_MAX_ERROR   3   // rgb -> hsv -> rgb
+
+// Largest allowed difference, per channel, from the input color
+#define TEST_ROUND_TRIP_MAX_DRIFT   3
+
+#define TEST_TIMING_PASSES          4   // passes over all 2^24 colors
+
+typedef c_InputEffectEngine::CRGB   CRGB;
+typedef c_InputEffectEngine::CHSV   CHSV;
+
+// dCHSV hue 0->360 sat 0->1.0 val 0->1.0
+struct dCHSV
+{
+    double h;
+    double s;
+    double v;
+};
+
+struct Error_t
+{
+    uint32_t    Max      = 0;
+    uint64_t    Sum      = 0;
+    uint64_t    Count    = 0;
+    CRGB        WorstRgb = {0, 0, 0};
+};
+
+// -----------------------------------------------------------------------------
+// Stand ins for the parts of the managers the engine calls
+// -----------------------------------------------------------------------------
+config_t    config;
+c_OutputMgr OutputMgr;
+c_InputMgr  InputMgr;
+
+c_OutputMgr::c_OutputMgr ()
+{}  // c_OutputMgr
+
+c_OutputMgr::~c_OutputMgr ()
+{}  // ~c_OutputMgr
+
+void c_OutputMgr::WriteChannelData (uint32_t, uint32_t, uint8_t*)
+{}  // WriteChannelData
+
+void c_OutputMgr::ClearBuffer ()
+{}  // ClearBuffer
+
+c_InputMgr::c_InputMgr ()
+{}  // c_InputMgr
+
+c_InputMgr::~c_InputMgr ()
+{}  // ~c_InputMgr
+
+// -----------------------------------------------------------------------------
+// The conversions as they were before the fixed point versions
+// -----------------------------------------------------------------------------
+static dCHSV OldRgb2Hsv (CRGB in_int)
+{
+    dCHSV   out;
+    double  r = double(in_int.r) / double(255.0);
+    double  g = double(in_int.g) / double(255.0);
+    double  b = double(in_int.b) / double(255.0);
+    double  min, max, delta;
+
+    min = r < g?r : g;
+    min = min < b?min : b;
+
+    max = r > g?r : g;
+    max = max > b?max : b;
+
+    out.v = max;
+    delta = max - min;
+
+    if (delta < 0.00001)
+    {
+        out.s = 0;
+        out.h = 0;
+
+        return(out);
+    }
+
+    out.s = (delta / max);
+
+    if (r >= max)
+    {
+        out.h = (g - b) / delta;
+    }
+    else
+    if (g >= max)
+    {
+        out.h = 2.0 + (b - r) / delta;
+    }
+    else
+    {
+        out.h = 4.0 + (r - g) / delta;
+    }
+
+    out.h *= 60.0;
+
+    if (out.h < 0.0) out.h += 360.0;
+
+    return(out);
+}  // OldRgb2Hsv
+
+// -----------------------------------------------------------------------------
+static CRGB OldHsv2Rgb (dCHSV in)
+{
+    double  hh, p, q, t, ff;
+    long    i;
+    double  r, g, b;
+
+    if (in.s <= 0.0)
+    {
+        r = g = b = in.v;
+    }
+    else
+    {
+        hh = in.h;
+
+        if (hh >= 360.0) hh = 0.0;
+
+        hh /= 60.0;
+        i   = (long)hh;
+        ff  = hh - i;
+        p   = in.v * (1.0 - in.s);
+        q   = in.v * ( 1.0 - (in.s * ff) );
+        t   = in.v * ( 1.0 - ( in.s * (1.0 - ff) ) );
+
+        switch (i)
+        {
+            case 0:  {r = in.v; g = t;    b = p;    break;}
+            case 1:  {r = q;    g = in.v; b = p;    break;}
+            case 2:  {r = p;    g = in.v; b = t;    break;}
+            case 3:  {r = p;    g = q;    b = in.v; break;}
+            case 4:  {r = t;    g = p;    b = in.v; break;}
+            default: {r = in.v; g = p;    b = q;    break;}
+        } // switch
+    }
+
+    CRGB out_int =
+    {
+        uint8_t (min (uint16_t (255), uint16_t (255 * r) ) ),
+        uint8_t (min (uint16_t (255), uint16_t (255 * g) ) ),
+        uint8_t (min (uint16_t (255), uint16_t (255 * b) ) )
+    };
+
+    return(out_int);
+}  // OldHsv2Rgb
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static inline CRGB RgbFromIndex (uint32_t Index)
+{
+    CRGB Response = {uint8_t (Index >> 16), uint8_t (Index >> 8), uint8_t (Index)};
+
+    return(Response);
+}  // RgbFromIndex
+
+// -----------------------------------------------------------------------------
+static void AddError (Error_t & Error, CRGB Actual, CRGB Expected, CRGB Input)
+{
+    uint32_t Diff = uint32_t (abs (int (Actual.r) - int (Expected.r) ) );
+    Diff = max (Diff, uint32_t (abs (int (Actual.g) - int (Expected.g) ) ) );
+    Diff = max (Diff, uint32_t (abs (int (Actual.b) - int (Expected.b) ) ) );
+
+    if (Diff > Error.Max)
+    {
+        Error.Max      = Diff;
+        Error.WorstRgb = Input;
+    }
+
+    Error.Sum += Diff;
+    ++Error.Count;
+}  // AddError
+
+// -----------------------------------------------------------------------------
+static bool Report (const char* Name, const Error_t & Error, uint32_t Limit, const char* InputName)
+{
+    bool Response = (Error.Max <= Limit);
+
+    printf ("%-34s max %u (limit %u) mean %.3f  worst %s %02x%02x%02x  %s\n",
+            Name,
+            Error.Max,
+            Limit,
+            double(Error.Sum) / double(max (Error.Count, uint64_t (1) ) ),
+            InputName,
+            Error.WorstRgb.r, Error.WorstRgb.g, Error.WorstRgb.b,
+            Response ? "ok" : "FAIL");
+
+    return(Response);
+}  // Report
+
+// -----------------------------------------------------------------------------
+// Checks
+// -----------------------------------------------------------------------------
+static bool CheckHsv2Rgb ()
+{
+    Error_t Error;
+
+    for (uint32_t Hue = 0; Hue < HSV_HUE_MAX; ++Hue)
+    {
+        for (uint32_t Sat = 0; Sat < 256; ++Sat)
+        {
+            for (uint32_t Val = 0; Val < 256; ++Val)
+            {
+                CHSV    In  = {uint16_t (Hue), uint8_t (Sat), uint8_t (Val)};
+                dCHSV   dIn = {double(Hue) * 360.0 / double(HSV_HUE_MAX), double(Sat) / 255.0, double(Val) / 255.0};
+
+                // report the worst case as hue sector, position and sat
+                CRGB    Input = {uint8_t (Hue >> 8), uint8_t (Hue), uint8_t (Sat)};
+
+                AddError (Error, c_InputEffectEngine::hsv2rgb (In), OldHsv2Rgb (dIn), Input);
+            }
+        }
+    }
+
+    return( Report ("hsv2rgb vs double", Error, TEST_HSV2RGB_MAX_ERROR, "hue/sat") );
+}  // CheckHsv2Rgb
+
+// -----------------------------------------------------------------------------
+static bool CheckRoundTrip ()
+{
+    Error_t VsOld;
+    Error_t NewDrift;
+    Error_t OldDrift;
+
+    for (uint32_t Index = 0; Index < (1UL << 24); ++Index)
+    {
+        CRGB In     = RgbFromIndex (Index);
+        CRGB NewOut = c_InputEffectEngine::hsv2rgb (c_InputEffectEngine::rgb2hsv (In) );
+        CRGB OldOut = OldHsv2Rgb (OldRgb2Hsv (In) );
+
+        AddError (VsOld,    NewOut, OldOut, In);
+        AddError (NewDrift, NewOut, In,     In);
+        AddError (OldDrift, OldOut, In,     In);
+    }
+
+    bool Response = true;
+    Response &= Report ("rgb -> hsv -> rgb vs double",   VsOld,    TEST_ROUND_TRIP_MAX_ERROR, "rgb");
+    Response &= Report ("rgb -> hsv -> rgb vs input",    NewDrift, TEST_ROUND_TRIP_MAX_DRIFT, "rgb");
+    Report ("double rgb -> hsv -> rgb vs input", OldDrift, 255, "rgb");
+
+    // on average the round trip must not drift further than the double one did
+    if ( (NewDrift.Sum * OldDrift.Count) > (OldDrift.Sum * NewDrift.Count) )
+    {
+        printf ("rgb -> hsv -> rgb drifts further from the input than the double version  FAIL\n");
+        Response = false;
+    }
+
+    return(Response);
+}  // CheckRoundTrip
+
+// -----------------------------------------------------------------------------
+// The sink keeps the compiler from dropping the conversions
+static volatile uint32_t TimingSink = 0;
+
+template <typename Function>
+static double NanosecondsPerCall (Function Convert)
+{
+    uint32_t Sum = 0;
+
+    auto Start = std::chrono::steady_clock::now ();
+
+    for (uint32_t Pass = 0; Pass < TEST_TIMING_PASSES; ++Pass)
+    {
+        for (uint32_t Index = 0; Index < (1UL << 24); ++Index)
+        {
+            Sum += Convert (Index);
+        }
+    }
+
+    auto End = std::chrono::steady_clock::now ();
+
+    TimingSink = TimingSink + Sum;
+
+    return( std::chrono::duration <double, std::nano> (End - Start).count () / ( double(TEST_TIMING_PASSES) * double(1UL << 24) ) );
+}  // NanosecondsPerCall
+
+// -----------------------------------------------------------------------------
+static void ReportTiming ()
+{
+    double NewRgb2Hsv = NanosecondsPerCall ([] (uint32_t Index) -> uint32_t
+    {
+        CHSV Out = c_InputEffectEngine::rgb2hsv (RgbFromIndex (Index) );
+        return(Out.h + Out.s + Out.v);
+    });
+
+    double OldRgb2HsvNs = NanosecondsPerCall ([] (uint32_t Index) -> uint32_t
+    {
+        dCHSV Out = OldRgb2Hsv (RgbFromIndex (Index) );
+        return(uint32_t (Out.h + Out.s + Out.v) );
+    });
+
+    // the hsv inputs are taken from the index so both get the same spread of hues
+    double NewHsv2Rgb = NanosecondsPerCall ([] (uint32_t Index) -> uint32_t
+    {
+        CHSV In  = {uint16_t ( (Index >> 16) * HSV_HUE_MAX / 256), uint8_t (Index >> 8), uint8_t (Index)};
+        CRGB Out = c_InputEffectEngine::hsv2rgb (In);
+        return(Out.r + Out.g + Out.b);
+    });
+
+    double OldHsv2RgbNs = NanosecondsPerCall ([] (uint32_t Index) -> uint32_t
+    {
+        dCHSV   In  = {double(Index >> 16) * 360.0 / 256.0, double(uint8_t (Index >> 8) ) / 255.0, double(uint8_t (Index) ) / 255.0};
+        CRGB    Out = OldHsv2Rgb (In);
+        return(Out.r + Out.g + Out.b);
+    });
+
+    printf ("\n%-10s %12s %12s\n", "ns/call", "fixed point", "double");
+    printf ("%-10s %12.2f %12.2f\n", "rgb2hsv", NewRgb2Hsv, OldRgb2HsvNs);
+    printf ("%-10s %12.2f %12.2f\n", "hsv2rgb", NewHsv2Rgb, OldHsv2RgbNs);
+}  // ReportTiming
+
+// -----------------------------------------------------------------------------
+int main (int argc, char** argv)
+{
+    bool Timing = true;
+
+    for (int Index = 1; Index < argc; ++Index)
+    {
+        String Arg = argv[Index];
+
+        if (Arg == "--no-timing")
+        {
+            Timing = false;
+        }
+        else
+        {
+            printf ("Usage: %s [--no-timing]\n"
+                    "  --no-timing   only check the accuracy\n",
+                    argv[0]);
+            return( (Arg == "--help") ? 0 : 2 );
+        }
+    }
+
+    bool Passed = true;
+
+    Passed &= CheckHsv2Rgb ();
+    Passed &= CheckRoundTrip ();
+
+    if (Timing)
+    {
+        ReportTiming ();
+    }
+
+    printf ("\n%s\n", Passed ? "PASSED" : "FAILED");
+
+    return(Passed ? 0 : 1);
+}  // main
@@ -0,0 +1,354 @@
+/*
+ * ServoPCA9685Test.cpp - Checks the value to tick conversion of
+ *                        c_OutputServoPCA9685 on the host (Linux)
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   The driver is set up through its config and fed every input value. The
+ *   ticks it sends to the (fake) device are compared with the map() / float
+ *   conversion that Poll used before the tick tables. 8 bit channels must
+ *   match exactly. 16 bit channels may be off by one tick.
+ *
+ *   16 bit mode must be refused for channels whose byte pair is outside of
+ *   the output buffer slice.
+ *
+ *   LED channels are checked for bus traffic: a level that is held must stop
+ *   being written, with and without dithering.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "OutputServoPCA9685.hpp"
+
+// -----------------------------------------------------------------------------
+// Local Structure and Data Definitions
+// -----------------------------------------------------------------------------
+
+#define TEST_16BIT_MAX_ERROR    1
+#define TEST_BUFFER_SIZE        (OM_SERVO_PCA9685_CHANNEL_LIMIT * 2)
+#define TEST_HOLD_FRAMES        (SERVO_PCA9685_DITHER_SETTLE_FRAMES * 4)
+
+struct TestConfig_t
+{
+    float       UpdateFrequency;
+    uint16_t    MinLevel;
+    uint16_t    MaxLevel;
+    bool        IsReversed;
+    bool        IsScaled;
+};
+
+static const float      Frequencies[] = {20, 50, 60, 100};
+static const uint16_t   Levels[][2]   =
+{
+    {SERVO_PCA9685_OUTPUT_MIN_PULSE_WIDTH, SERVO_PCA9685_OUTPUT_MAX_PULSE_WIDTH},
+    {500,  2500},
+    {1000, 2000},
+    {0,    10000},
+    {2350, 650},    // Min above Max turns the servo the other way
+    {1500, 1500},
+};
+
+static uint8_t OutputBuffer[TEST_BUFFER_SIZE];
+
+// -----------------------------------------------------------------------------
+// Stand ins for the parts of the output manager the driver calls
+// -----------------------------------------------------------------------------
+c_OutputMgr OutputMgr;
+
+c_OutputMgr::c_OutputMgr ()
+{}  // c_OutputMgr
+
+c_OutputMgr::~c_OutputMgr ()
+{}  // ~c_OutputMgr
+
+// -----------------------------------------------------------------------------
+static void GetDriverName (String & Name)
+{
+    Name = "PCA9685Test";
+}  // GetDriverName
+
+// -----------------------------------------------------------------------------
+/* The conversion done by Poll before the tick tables were added */
+static uint16_t OldTicks (const TestConfig_t & Config, uint16_t Value, uint16_t MaxScaledValue)
+{
+    uint16_t    MinScaledValue = 0;
+    uint16_t    Final_value    = Value;
+
+    if (Config.IsReversed)
+    {
+        MinScaledValue = MaxScaledValue;
+        MaxScaledValue = 0;
+    }
+
+    if (Config.IsScaled)
+    {
+        uint16_t pulse_width = map (
+            Value,
+            MinScaledValue,
+            MaxScaledValue,
+            Config.MinLevel,
+            Config.MaxLevel);
+        Final_value = int( ( float(pulse_width) / float(MicroSecondsInASecond) ) * float(Config.UpdateFrequency) * 4096.0 );
+    }
+
+    return(Final_value);
+}  // OldTicks
+
+// -----------------------------------------------------------------------------
+/* The LEDn_OFF value the device holds for a channel, in the driver's format */
+static uint16_t DeviceTicks (uint8_t ChannelId)
+{
+    uint8_t*    Registers = &HostPca9685.Registers[PCA9685_LED0_ON_L + (ChannelId * 4)];
+    uint16_t    Response  = uint16_t ( (Registers[3] << 8) | Registers[2]);
+
+    if (Registers[1] & 0x10)
+    {
+        Response = SERVO_PCA9685_FULL_ON;
+    }
+
+    return(Response);
+}  // DeviceTicks
+
+// -----------------------------------------------------------------------------
+static void ApplyConfig (c_OutputServoPCA9685 & Driver, const TestConfig_t & Config, bool Is16Bit, bool IsLed = false, bool EnableDither = false)
+{
+    DynamicJsonDocument JsonDoc (4096);
+    JsonObject          JsonConfig = JsonDoc.to <JsonObject> ();
+
+    JsonConfig[CN_updateinterval]            = Config.UpdateFrequency;
+    JsonConfig[OM_SERVO_PCA9685_DITHER_NAME] = EnableDither;
+
+    JsonArray   JsonChannelList = JsonConfig.createNestedArray (CN_channels);
+    JsonObject  JsonChannelData = JsonChannelList.createNestedObject ();
+
+    JsonChannelData[CN_id]  = 0;
+    JsonChannelData[CN_en]  = true;
+    JsonChannelData[CN_Min] = Config.MinLevel;
+    JsonChannelData[CN_Max] = Config.MaxLevel;
+    JsonChannelData[CN_rev] = Config.IsReversed;
+    JsonChannelData[CN_b16] = Is16Bit;
+    JsonChannelData[CN_sca] = Config.IsScaled;
+    JsonChannelData[CN_hv]  = 0;
+    JsonChannelData[CN_led] = IsLed;
+
+    Driver.SetConfig (JsonConfig);
+}  // ApplyConfig
+
+// -----------------------------------------------------------------------------
+/* Send every input value through channel 0 and compare the device registers
+ * with the old conversion. Returns the largest difference in ticks.
+ */
+static uint32_t CheckConfig (c_OutputServoPCA9685 & Driver, const TestConfig_t & Config, bool Is16Bit, uint32_t & Mismatches)
+{
+    uint32_t    MaxError = 0;
+    uint32_t    MaxValue = Is16Bit ? 65535 : 255;
+
+    ApplyConfig (Driver, Config, Is16Bit);
+
+    for (uint32_t Value = 0; Value <= MaxValue; ++Value)
+    {
+        OutputBuffer[0] = uint8_t (Value);
+        OutputBuffer[1] = uint8_t (Value >> 8);
+        Driver.MarkChannelsDirty (uint32_t (-1));
+        Driver.Poll ();
+
+        uint16_t    Expected = OldTicks (Config, uint16_t (Value), uint16_t (MaxValue));
+        uint16_t    Actual   = DeviceTicks (0);
+        uint32_t    Error    = uint32_t (abs (int32_t (Actual) - int32_t (Expected)));
+
+        if ( (Is16Bit && (Error > TEST_16BIT_MAX_ERROR)) || (!Is16Bit && (0 != Error)) )
+        {
+            if (0 == Mismatches)
+            {
+                logcon (String (F ("  value ")) + String (Value) + F (": expected ") + String (Expected) + F (" got ") + String (Actual));
+            }
+
+            ++Mismatches;
+        }
+
+        MaxError = max (MaxError, Error);
+    }
+
+    return(MaxError);
+}  // CheckConfig
+
+// -----------------------------------------------------------------------------
+/* Ask for 16 bit mode on every channel. Only the channels whose two bytes are
+ * inside the slice may keep it. Returns the number of channels that got it wrong.
+ */
+static uint32_t CheckSliceLimit (c_OutputServoPCA9685 & Driver)
+{
+    uint32_t            Errors = 0;
+    DynamicJsonDocument JsonDoc (8192);
+    JsonObject          JsonConfig      = JsonDoc.to <JsonObject> ();
+    JsonArray           JsonChannelList = JsonConfig.createNestedArray (CN_channels);
+
+    for (uint32_t ChannelId = 0; ChannelId < OM_SERVO_PCA9685_CHANNEL_LIMIT; ++ChannelId)
+    {
+        JsonObject JsonChannelData = JsonChannelList.createNestedObject ();
+
+        JsonChannelData[CN_id]  = ChannelId;
+        JsonChannelData[CN_b16] = true;
+    }
+
+    Driver.SetConfig (JsonConfig);
+
+    // SetConfig writes back the settings it is using
+    JsonArray   JsonChannelsUsed = JsonConfig[CN_channels];
+    uint32_t    ChannelId        = 0;
+
+    for (JsonVariant JsonChannelData : JsonChannelsUsed)
+    {
+        bool    Is16Bit  = JsonChannelData[CN_b16].as <bool> ();
+        bool    Expected = ( (ChannelId * 2) + 1 ) < Driver.GetBufferUsedSize ();
+
+        if (Is16Bit != Expected)
+        {
+            logcon (String (F ("  channel ")) + String (ChannelId) + F (" 16 bit: ") + String (Is16Bit));
+            ++Errors;
+        }
+
+        ++ChannelId;
+    }
+
+    if (OM_SERVO_PCA9685_CHANNEL_LIMIT != ChannelId)
+    {
+        ++Errors;
+    }
+
+    return(Errors);
+}  // CheckSliceLimit
+
+// -----------------------------------------------------------------------------
+/* Step an LED channel through every 8 bit level and hold each one. Returns the
+ * number of levels that were still being written once the hold had settled.
+ * DitheredLevels counts the levels that were written more than once.
+ */
+static uint32_t CheckLedHold (c_OutputServoPCA9685 & Driver, bool EnableDither, uint32_t & DitheredLevels)
+{
+    uint32_t        BusyLevels = 0;
+    TestConfig_t    Config     = {SERVO_PCA9685_UPDATE_FREQUENCY, 0, 0, false, false};
+
+    ApplyConfig (Driver, Config, false, true, EnableDither);
+
+    for (uint32_t Value = 0; Value <= 255; ++Value)
+    {
+        uint32_t StartTransactions = HostPca9685.Transactions;
+
+        OutputBuffer[0] = uint8_t (Value);
+        Driver.MarkChannelsDirty (uint32_t (-1));
+
+        for (uint32_t Frame = 0; Frame < TEST_HOLD_FRAMES; ++Frame)
+        {
+            if ( (SERVO_PCA9685_DITHER_SETTLE_FRAMES + 1) == Frame )
+            {
+                DitheredLevels   += ( (HostPca9685.Transactions - StartTransactions) > 1) ? 1 : 0;
+                StartTransactions = HostPca9685.Transactions;
+            }
+
+            Driver.Poll ();
+        }
+
+        if (HostPca9685.Transactions != StartTransactions)
+        {
+            if (0 == BusyLevels)
+            {
+                logcon (String (F ("  value ")) + String (Value) + F (" is still written after ") + String (TEST_HOLD_FRAMES) + F (" frames"));
+            }
+
+            ++BusyLevels;
+        }
+    }
+
+    return(BusyLevels);
+}  // CheckLedHold
+
+// -----------------------------------------------------------------------------
+int main (int, char**)
+{
+    uint32_t Failures = 0;
+    uint32_t Cases    = 0;
+
+    c_OutputServoPCA9685 Driver (c_OutputMgr::e_OutputChannelIds::OutputChannelId_Start,
+                                 gpio_num_t (-1),
+                                 uart_port_t (-1),
+                                 c_OutputMgr::e_OutputType::OutputType_Servo_PCA9685,
+                                 HostPca9685.Address);
+
+    Driver.SetOutputBufferAddress (OutputBuffer);
+    Driver.Begin ();
+
+    printf ("%-6s %-12s %-5s %-6s %-6s %9s %10s\n", "bits", "min-max", "hz", "rev", "scaled", "max err", "mismatches");
+
+    for (uint32_t Bits = 8; Bits <= 16; Bits += 8)
+    {
+        for (float UpdateFrequency : Frequencies)
+        {
+            for (const uint16_t* Level : Levels)
+            {
+                for (uint32_t Flags = 0; Flags < 4; ++Flags)
+                {
+                    TestConfig_t Config = {UpdateFrequency, Level[0], Level[1], bool (Flags & 1), bool (Flags & 2)};
+
+                    // without scaling the range and frequency are not used
+                    if (!Config.IsScaled && ( (Level != Levels[0]) || (UpdateFrequency != Frequencies[0]) ) )
+                    {
+                        continue;
+                    }
+
+                    uint32_t    Mismatches = 0;
+                    uint32_t    MaxError   = CheckConfig (Driver, Config, (16 == Bits), Mismatches);
+
+                    printf ("%-6u %5u-%-6u %-5.0f %-6s %-6s %9u %10u\n",
+                            Bits, Config.MinLevel, Config.MaxLevel, Config.UpdateFrequency,
+                            Config.IsReversed ? "yes" : "no", Config.IsScaled ? "yes" : "no",
+                            MaxError, Mismatches);
+
+                    ++Cases;
+                    Failures += (0 != Mismatches) ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    printf ("\n%-8s %15s %15s\n", "dither", "dithered levels", "busy when held");
+
+    for (uint32_t EnableDither = 0; EnableDither < 2; ++EnableDither)
+    {
+        uint32_t    DitheredLevels = 0;
+        uint32_t    BusyLevels     = CheckLedHold (Driver, bool (EnableDither), DitheredLevels);
+
+        printf ("%-8s %15u %15u\n", EnableDither ? "on" : "off", DitheredLevels, BusyLevels);
+
+        ++Cases;
+        Failures += (0 != BusyLevels) ? 1 : 0;
+
+        // dithering that never happens is not being tested
+        if (EnableDither && (0 == DitheredLevels))
+        {
+            ++Failures;
+        }
+    }
+
+    uint32_t SliceErrors = CheckSliceLimit (Driver);
+
+    printf ("\n16 bit channels outside of the slice: %s\n", (0 == SliceErrors) ? "refused" : "FAILED");
+    ++Cases;
+    Failures += (0 != SliceErrors) ? 1 : 0;
+
+    printf ("%u of %u cases failed\n", Failures, Cases);
+
+    return( (0 == Failures) ? 0 : 1 );
+}  // main
@@ -0,0 +1,47 @@
+#pragma once
+/*
+ * Adafruit_PWMServoDriver.h - Host stand in. Sets up the PCA9685 in
+ *                             host/HostWire.cpp the way the library does
+ */
+
+#include "wire.h"
+
+#define PCA9685_I2C_ADDRESS 0x40
+#define PCA9685_MODE1       0x00
+#define PCA9685_LED0_ON_L   0x06
+#define PCA9685_PRESCALE    0xFE
+
+#define MODE1_RESTART       0x80
+#define MODE1_AI            0x20
+#define MODE1_SLEEP         0x10
+
+class Adafruit_PWMServoDriver
+{
+public:
+    Adafruit_PWMServoDriver (uint8_t Address, TwoWire & Bus) : _Address (Address), _Bus (Bus) {}
+
+    void begin ()
+    {
+        // reset
+        Write8 (PCA9685_MODE1, MODE1_RESTART);
+    }
+
+    void setPWMFreq (float Frequency)
+    {
+        float Prescale = ( (25000000.0f / (Frequency * 4096.0f) ) + 0.5f) - 1.0f;
+        Write8 (PCA9685_PRESCALE, uint8_t (constrain (Prescale, 3.0f, 255.0f) ) );
+        Write8 (PCA9685_MODE1, MODE1_RESTART | MODE1_AI);
+    }
+
+private:
+    void Write8 (uint8_t Register, uint8_t Value)
+    {
+        _Bus.beginTransmission (_Address);
+        _Bus.write (Register);
+        _Bus.write (Value);
+        _Bus.endTransmission ();
+    }
+
+    uint8_t     _Address;
+    TwoWire &   _Bus;
+};
@@ -0,0 +1,228 @@
+#pragma once
+/*
+ * Arduino.h - Host (Linux) stand in for the parts of the Arduino core used
+ *             by the modules that are built natively (see host/README.md)
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+#include <functional>
+#include <algorithm>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+typedef uint8_t byte;
+typedef unsigned int uint;
+
+#define PROGMEM
+#define F(x)        (x)
+#define FPSTR(x)    (x)
+#define F_CPU       240000000L
+#define PI          3.1415926535897932384626433832795
+
+#define HEX         16
+#define DEC         10
+#define LOW         0
+#define HIGH        1
+#define INPUT       0x01
+#define OUTPUT      0x03
+#define INPUT_PULLUP 0x05
+#define OUTPUT_OPEN_DRAIN 0x13
+#define SERIAL_8N1  0x800001c
+
+#define likely(x)   __builtin_expect (!!(x), 1)
+#define unlikely(x) __builtin_expect (!!(x), 0)
+#define constrain(amt, low, high)   ( (amt) < (low) ? (low) : ( (amt) > (high) ? (high) : (amt) ) )
+
+using std::min;
+using std::max;
+
+// -----------------------------------------------------------------------------
+class String{
+public:
+String () {}
+String (const char* Text) : s (Text ? Text : "") {}
+String (const std::string & Text) : s (Text) {}
+String (char c) : s (1, c) {}
+String (int Value, int Base = DEC)                  {FromUnsigned ( (Value < 0) ? -(unsigned long long)(Value) : Value, Base, Value < 0);}
+String (unsigned int Value, int Base = DEC)         {FromUnsigned (Value, Base, false);}
+String (long Value, int Base = DEC)                 {FromUnsigned ( (Value < 0) ? -(unsigned long long)(Value) : Value, Base, Value < 0);}
+String (unsigned long Value, int Base = DEC)        {FromUnsigned (Value, Base, false);}
+String (long long Value, int Base = DEC)            {FromUnsigned ( (Value < 0) ? -(unsigned long long)(Value) : Value, Base, Value < 0);}
+String (unsigned long long Value, int Base = DEC)   {FromUnsigned (Value, Base, false);}
+String (unsigned char Value, int Base = DEC)        {FromUnsigned (Value, Base, false);}
+String (double Value, unsigned int Decimals = 2)
+{
+    char Buffer[64];
+    snprintf (Buffer, sizeof (Buffer), "%.*f", Decimals, Value);
+    s = Buffer;
+}
+
+const char* c_str () const {return(s.c_str () );}
+unsigned int length () const {return(s.size () );}
+bool isEmpty () const {return(s.empty () );}
+void reserve (unsigned int Size) {s.reserve (Size);}
+bool concat (const char* Text) {s += Text; return(true);}
+bool concat (const String & Text) {s += Text.s; return(true);}
+bool concat (const char* Text, unsigned int Length) {s.append (Text, Length); return(true);}
+char operator [] (unsigned int Index) const {return( (Index < s.size () ) ? s[Index] : 0 );}
+char & operator [] (unsigned int Index) {return(s[Index]);}
+String & operator = (const char* Text) {s = Text ? Text : ""; return(*this);}
+String & operator += (const String & Text) {s += Text.s; return(*this);}
+String & operator += (const char* Text) {s += Text; return(*this);}
+String & operator += (char c) {s += c; return(*this);}
+bool operator == (const String & Text) const {return(s == Text.s);}
+bool operator == (const char* Text) const {return(s == Text);}
+bool operator != (const String & Text) const {return(s != Text.s);}
+bool operator != (const char* Text) const {return(s != Text);}
+bool operator < (const String & Text) const {return(s < Text.s);}
+bool equalsIgnoreCase (const String & Text) const {return(0 == strcasecmp (s.c_str (), Text.s.c_str () ) );}
+int indexOf (const char* Text) const {size_t i = s.find (Text); return( (std::string::npos == i) ? -1 : int(i) );}
+int lastIndexOf (const char* Text) const {size_t i = s.rfind (Text); return( (std::string::npos == i) ? -1 : int(i) );}
+String substring (unsigned int From) const {return( (From < s.size () ) ? String (s.substr (From) ) : String () );}
+String substring (unsigned int From, unsigned int To) const {return( (From < s.size () ) ? String (s.substr (From, (To > From) ? To - From : 0) ) : String () );}
+long toInt () const {return(atol (s.c_str () ) );}
+float toFloat () const {return(float(atof (s.c_str () ) ) );}
+
+// lets ArduinoJson serialise into a String
+size_t write (uint8_t c) {s += char(c); return(1);}
+size_t write (const uint8_t* Data, size_t Length) {s.append ( (const char*)Data, Length); return(Length);}
+
+friend String operator + (const String & a, const String & b) {return(String (a.s + b.s) );}
+friend String operator + (const String & a, const char* b) {return(String (a.s + b) );}
+friend String operator + (const char* a, const String & b) {return(String (a + b.s) );}
+friend String operator + (const String & a, char b) {return(String (a.s + b) );}
+template <typename T>
+friend String operator + (const String & a, T b) {return(a + String (b) );}
+
+private:
+void FromUnsigned (unsigned long long Value, int Base, bool Negative)
+{
+    char Buffer[72];
+    char* p = &Buffer[sizeof (Buffer) - 1];
+    *p = 0;
+
+    do
+    {
+        unsigned Digit = unsigned(Value % unsigned(Base) );
+        *--p  = char( (Digit < 10) ? ('0' + Digit) : ('a' + Digit - 10) );
+        Value /= unsigned(Base);
+    } while (Value);
+
+    if (Negative)
+    {
+        *--p = '-';
+    }
+    s = p;
+}
+
+std::string s;
+}; // String
+
+// ArduinoJson (ARDUINOJSON_ENABLE_ARDUINO_STRING) expects this type to exist
+class StringSumHelper : public String{
+public:
+using String::String;
+StringSumHelper (const String & Text) : String (Text) {}
+};
+
+// -----------------------------------------------------------------------------
+class Stream{
+public:
+virtual ~Stream () {}
+virtual int available () {return(0);}
+virtual int read () {return(-1);}
+virtual int peek () {return(-1);}
+virtual size_t write (uint8_t) {return(0);}
+virtual size_t write (const uint8_t* Data, size_t Length);
+virtual void flush () {}
+size_t print (const String & Text) {return( write ( (const uint8_t*)Text.c_str (), Text.length () ) );}
+size_t println (const String & Text) {return( print (Text + "\n") );}
+size_t println () {return( print ("\n") );}
+};
+
+// A serial port on the host. Serial writes to stdout. Any other port talks to
+// the device (tty / pty) given to SetDevice() before begin().
+class HardwareSerial : public Stream{
+public:
+HardwareSerial (int _Port) : Port (_Port) {}
+void begin (unsigned long  Baud,
+ uint32_t                  Config = SERIAL_8N1,
+ int8_t                    RxPin = -1,
+ int8_t                    TxPin = -1,
+ bool                      Invert = false);
+void end ();
+int available () override;
+int read () override;
+int peek () override;
+size_t write (uint8_t Data) override {return( write (&Data, 1) );}
+size_t write (const uint8_t* Data, size_t Length) override;
+void flush () override {}
+int availableForWrite () {return(128);}
+void setRxBufferSize (size_t) {}
+void SetDevice (const char* Path) {Device = Path;}
+
+private:
+int Port;
+int fd = -1;
+int PeekedByte = -1;
+std::string Device;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+class EspClass{
+public:
+void restart () {exit (0);}
+uint32_t getFreeHeap () {return(256 * 1024);}
+uint32_t getMaxAllocHeap () {return(128 * 1024);}
+const char* getSdkVersion () {return("host");}
+};
+extern EspClass ESP;
+
+// -----------------------------------------------------------------------------
+unsigned long millis ();
+unsigned long micros ();
+void delay (uint32_t DelayMs);
+void delayMicroseconds (uint32_t DelayUs);
+void yield ();
+long random (long Max);
+long random (long Min, long Max);
+void randomSeed (unsigned long Seed);
+long map (long Value, long InMin, long InMax, long OutMin, long OutMax);
+uint32_t esp_random ();
+int64_t esp_timer_get_time ();
+inline void pinMode (uint8_t, uint8_t) {}
+inline void digitalWrite (uint8_t, uint8_t) {}
+inline int digitalRead (uint8_t) {return(LOW);}
+
+// -----------------------------------------------------------------------------
+// Host only. millis() and micros() follow the wall clock unless the virtual
+// clock is selected. The virtual clock only moves when HostAdvanceMicros or
+// delay() is called so a run is repeatable.
+void HostUseVirtualClock (bool Enable);
+void HostAdvanceMicros (uint64_t DeltaUs);
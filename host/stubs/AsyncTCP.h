@@ -0,0 +1,4 @@
+#pragma once
+/*
+ * AsyncTCP.h - Host stand in. Networking is not part of the host build
+ */
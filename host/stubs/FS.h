@@ -0,0 +1,26 @@
+#pragma once
+/*
+ * FS.h - Host stand in. No file system is used through it on the host
+ */
+
+#include <Arduino.h>
+
+namespace fs
+{
+class File{
+public:
+operator bool () const {return(false);}
+size_t size () {return(0);}
+size_t read (uint8_t*, size_t) {return(0);}
+size_t write (const uint8_t*, size_t) {return(0);}
+void close () {}
+};
+class FS{
+public:
+File open (const char*, const char* = "r") {return(File () );}
+bool exists (const char*) {return(false);}
+bool remove (const char*) {return(false);}
+};
+} // namespace fs
+
+using fs::File;
@@ -0,0 +1,6 @@
+#pragma once
+/*
+ * LittleFS.h - Host stand in. Config files go through host/HostFileMgr.cpp
+ */
+
+#include "FS.h"
@@ -0,0 +1,8 @@
+#pragma once
+/*
+ * SD.h - Host stand in
+ */
+
+#include "FS.h"
+
+#define SD_SCK_MHZ(x)   (x)
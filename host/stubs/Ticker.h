@@ -0,0 +1,4 @@
+#pragma once
+/*
+ * Ticker.h - Host stand in. Nothing is needed from it
+ */
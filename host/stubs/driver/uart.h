@@ -0,0 +1,11 @@
+#pragma once
+/*
+ * uart.h - Host stand in. Pin routing has no meaning on the host
+ */
+
+#include "hal/uart_types.h"
+#include "esp_err.h"
+
+#define UART_PIN_NO_CHANGE  (-1)
+
+inline esp_err_t uart_set_pin (uart_port_t, int, int, int, int) {return(ESP_OK);}
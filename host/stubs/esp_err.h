@@ -0,0 +1,10 @@
+#pragma once
+/*
+ * esp_err.h - Host stand in
+ */
+
+typedef int esp_err_t;
+
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERROR_CHECK(x)      (void)(x)
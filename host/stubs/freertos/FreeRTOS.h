@@ -0,0 +1,29 @@
+#pragma once
+/*
+ * FreeRTOS.h - Host stand in. Only the types and calls the natively built modules use
+ */
+
+#include <stdint.h>
+
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef void* QueueHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef void (* TaskFunction_t)(void*);
+typedef struct
+{
+    int Unused;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    {0}
+#define portENTER_CRITICAL(x)           (void)(x)
+#define portEXIT_CRITICAL(x)            (void)(x)
+#define portMAX_DELAY                   0xffffffff
+#define portTICK_PERIOD_MS              1
+#define configTICK_RATE_HZ              1000
+#define pdTRUE                          1
+#define pdFALSE                         0
+#define pdPASS                          1
+#define pdMS_TO_TICKS(x)                (x)
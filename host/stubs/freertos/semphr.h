@@ -0,0 +1,10 @@
+#pragma once
+/*
+ * semphr.h - Host stand in. The host build is single threaded
+ */
+
+#include "FreeRTOS.h"
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex () {return( (SemaphoreHandle_t)1 );}
+inline BaseType_t xSemaphoreTake (SemaphoreHandle_t, TickType_t) {return(pdTRUE);}
+inline BaseType_t xSemaphoreGive (SemaphoreHandle_t) {return(pdTRUE);}
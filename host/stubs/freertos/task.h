@@ -0,0 +1,6 @@
+#pragma once
+/*
+ * task.h - Host stand in. The host build is single threaded
+ */
+
+#include "FreeRTOS.h"
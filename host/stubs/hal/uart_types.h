@@ -0,0 +1,12 @@
+#pragma once
+/*
+ * uart_types.h - Host stand in
+ */
+
+typedef enum
+{
+    UART_NUM_0 = 0,
+    UART_NUM_1,
+    UART_NUM_2,
+    UART_NUM_MAX,
+} uart_port_t;
@@ -0,0 +1,4 @@
+#pragma once
+/*
+ * uart_reg.h - Host stand in. Nothing is needed from it
+ */
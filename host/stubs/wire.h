@@ -0,0 +1,33 @@
+#pragma once
+/*
+ * wire.h - Host stand in. The bus has one PCA9685 on it, see host/HostWire.cpp
+ */
+
+#include "Arduino.h"
+
+class TwoWire
+{
+public:
+    bool begin (int Sda = -1, int Scl = -1, uint32_t Frequency = 0);
+    bool end ();
+    void setClock (uint32_t) {}
+    void beginTransmission (uint8_t Address);
+    size_t write (uint8_t Data);
+    uint8_t endTransmission (bool SendStop = true);
+    uint8_t requestFrom (uint8_t Address, uint8_t Quantity, bool SendStop = true);
+    int available ();
+    int read ();
+};
+
+extern TwoWire Wire;
+
+// the device on the bus
+struct HostPca9685_t
+{
+    uint8_t     Address      = 0x40;
+    bool        Present      = true;
+    uint8_t     Registers[256];
+    uint32_t    Transactions = 0;   // write transactions that reached the device
+};
+
+extern HostPca9685_t HostPca9685;
@@ -869,6 +869,8 @@ function ProcessModeConfigurationDataServoPCA9685(modeControlName, channelId, Co
 
     let ChannelConfigs = Config.channels;
 
+    $(modeControlName + ' #servo_pca9685 #dither').prop("checked", Config.dither);
+
     // add as many rows as we need
     for (let CurrentRowId = 1; CurrentRowId <= ChannelConfigs.length; CurrentRowId++) {
         // console.log("CurrentRowId = " + CurrentRowId);
@@ -913,11 +915,17 @@ function ProcessModeConfigurationDataServoPCA9685(modeControlName, channelId, Co
         $(jqSelector).append('<option value=5>16 Bit Absolute - Reversed</option>');
         $(jqSelector).append('<option value=6>16 Bit Scaled</option>');
         $(jqSelector).append('<option value=7>16 Bit Scaled - Reversed</option>');
+        $(jqSelector).append('<option value=8> 8 Bit LED</option>');
+        $(jqSelector).append('<option value=9> 8 Bit LED - Reversed</option>');
+        $(jqSelector).append('<option value=12>16 Bit LED</option>');
+        $(jqSelector).append('<option value=13>16 Bit LED - Reversed</option>');
 
-        // set the current selector value
+        // set the current selector value. LED channels ignore the scaled flag
+        let led = CurrentChannelConfig.led ? true : false;
         $(jqSelector).val((CurrentChannelConfig.rev << 0) +
-            (CurrentChannelConfig.sca << 1) +
-            (CurrentChannelConfig.b16 << 2));
+            ((led ? false : CurrentChannelConfig.sca) << 1) +
+            (CurrentChannelConfig.b16 << 2) +
+            (led << 3));
     });
 
 } // ProcessModeConfigurationDataServoPCA9685
@@ -1070,6 +1078,7 @@ function ProcessReceivedJsonConfigMessage(JsonConfigData) {
         if ({}.hasOwnProperty.call(Input_Config, "MP3")) {
             let audioconfig = Input_Config.MP3;
             $('#AudioRand').prop("checked", audioconfig.randomize);
+            $('#AudioNoRepeat').val(audioconfig.norepeat);
         }
     }
 
@@ -1312,6 +1321,7 @@ function ExtractConfigFromHtmlPage(JsonConfig, SectionName) {
         if("MP3" === SectionName)
         {
             CurrentConfigurationData.randomize = $('#AudioRand').prop("checked");
+            CurrentConfigurationData.norepeat = parseInt($('#AudioNoRepeat').val(), 10);
         }
     });
 
@@ -1355,6 +1365,7 @@ function ExtractChannelConfigFromHtmlPage(JsonConfig, SectionName) {
             // console.log("ServoName: " + ServoName);
 
             ChannelConfig.updateinterval = parseInt($(modeControlName + ' #servo_pca9685 #updateinterval').val(), 10);
+            ChannelConfig.dither = $(modeControlName + ' #servo_pca9685 #dither').prop("checked");
             $.each(ChannelConfig.channels, function (i, CurrentChannelConfig) {
                 // console.info("Current Channel Id = " + CurrentChannelConfig.id);
                 let currentChannelRowId  = CurrentChannelConfig.id + 1;
@@ -1367,6 +1378,7 @@ function ExtractChannelConfigFromHtmlPage(JsonConfig, SectionName) {
                 CurrentChannelConfig.rev = (ServoDataType & 0x01) ? true : false;
                 CurrentChannelConfig.sca = (ServoDataType & 0x02) ? true : false;
                 CurrentChannelConfig.b16 = (ServoDataType & 0x04) ? true : false;
+                CurrentChannelConfig.led = (ServoDataType & 0x08) ? true : false;
             });
         }
         else if (ChannelConfig.type === "Effects") {
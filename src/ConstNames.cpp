@@ -115,6 +115,8 @@ const CN_PROGMEM char   CN_ip                       [] = "ip";
 const CN_PROGMEM char   CN_input                    [] = "input";
 const CN_PROGMEM char   CN_input_config             [] = "input_config";
 const CN_PROGMEM char   CN_last_clientIP            [] = "last_clientIP";
+const CN_PROGMEM char   CN_led                      [] = "led";
+const CN_PROGMEM char   CN_lights                   [] = "lights";
 const CN_PROGMEM char   CN_long                     [] = "long";
 const CN_PROGMEM char   CN_lwt                      [] = "lwt";
 const CN_PROGMEM char   CN_mac                      [] = "mac";
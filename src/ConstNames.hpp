@@ -124,6 +124,8 @@ extern const CN_PROGMEM char    CN_ip[];
 extern const CN_PROGMEM char    CN_input[];
 extern const CN_PROGMEM char    CN_input_config[];
 extern const CN_PROGMEM char    CN_last_clientIP[];
+extern const CN_PROGMEM char    CN_led[];
+extern const CN_PROGMEM char    CN_lights[];
 extern const CN_PROGMEM char    CN_long[];
 extern const CN_PROGMEM char    CN_lwt[];
 extern const CN_PROGMEM char    CN_mac[];
@@ -0,0 +1,410 @@
+/*
+ * DFPlayerAsync.cpp - Non blocking DFPlayer Mini protocol engine
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "DFPlayerAsync.hpp"
+
+    #define DFPLAYER_START_BYTE     0x7E
+    #define DFPLAYER_VERSION        0xFF
+    #define DFPLAYER_LENGTH         0x06
+    #define DFPLAYER_END_BYTE       0xEF
+
+// -----------------------------------------------------------------------------
+c_DFPlayerAsync::c_DFPlayerAsync ()
+{
+    for (int16_t & CurrentCount : FolderFileCount)
+    {
+        CurrentCount = -1;
+    }
+}   // c_DFPlayerAsync
+
+// -----------------------------------------------------------------------------
+c_DFPlayerAsync::~c_DFPlayerAsync ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+}  // ~c_DFPlayerAsync
+
+// -----------------------------------------------------------------------------
+void c_DFPlayerAsync::Begin (Stream & Port)
+{
+    // DEBUG_START;
+
+    pPort       = &Port;
+    NextSendMs  = millis ();
+
+    // DEBUG_END;
+}  // Begin
+
+// -----------------------------------------------------------------------------
+bool c_DFPlayerAsync::Enqueue (uint8_t Command, uint16_t Parameter)
+{
+    // DEBUG_START;
+
+    bool    Response = false;
+
+    do  // once
+    {
+        uint8_t NextTail = (QueueTail + 1) % DFPLAYER_QUEUE_SIZE;
+
+        if (NextTail == QueueHead)
+        {
+            ++QueueOverflows;
+            logcon ( String ( F ("Command queue is full. Dropped command 0x") ) + String (Command, HEX) );
+            break;
+        }
+
+        Queue[QueueTail].Command    = Command;
+        Queue[QueueTail].Parameter  = Parameter;
+        QueueTail                   = NextTail;
+        Response                    = true;
+
+        if (IsPlayCommand (Command) )
+        {
+            ++QueuedPlays;
+        }
+    } while (false);
+
+    // DEBUG_END;
+    return(Response);
+}  // Enqueue
+
+// -----------------------------------------------------------------------------
+void c_DFPlayerAsync::Poll ()
+{
+    // _ DEBUG_START;
+
+    do  // once
+    {
+        if (nullptr == pPort)
+        {
+            break;
+        }
+
+        // take whatever has arrived. Never wait for more
+        while (pPort->available () > 0)
+        {
+            ParseByte ( uint8_t ( pPort->read () ) );
+        }
+
+        uint32_t Now = millis ();
+
+        if (AwaitingReply)
+        {
+            if ( int32_t (Now - ReplyDeadlineMs) < 0)
+            {
+                break;
+            }
+
+            // DEBUG_V (String ("Reply timeout for: 0x") + String (AwaitingReply, HEX));
+            ++ReplyTimeouts;
+            AwaitingReply = 0;
+        }
+
+        if ( (QueueHead == QueueTail) || (int32_t (Now - NextSendMs) < 0) )
+        {
+            break;
+        }
+
+        QueueEntry_t Entry = Queue[QueueHead];
+        QueueHead = (QueueHead + 1) % DFPLAYER_QUEUE_SIZE;
+
+        SendFrame (Entry.Command, Entry.Parameter);
+        NextSendMs = Now + ( (CmdReset == Entry.Command) ? DFPLAYER_RESET_GAP_MS : DFPLAYER_COMMAND_GAP_MS );
+
+        if (IsPlayCommand (Entry.Command) )
+        {
+            --QueuedPlays;
+            PlayState = PlayStatePlaying;
+            LastPlaySentMs = Now;
+        }
+
+        // The player state follows the command. A status query corrects it if the player did not
+        switch (Entry.Command)
+        {
+            case CmdPause :
+            {
+                PlayState = PlayStatePaused;
+                break;
+            }
+
+            case CmdStop :
+            case CmdReset :
+            {
+                PlayState = PlayStateStopped;
+                break;
+            }
+
+            case QueryFolderFileCount :
+            {
+                AwaitingFolder = uint8_t (Entry.Parameter);
+            }   // fall through
+
+            case QueryStatus :
+            case QuerySdFileCount :
+            {
+                AwaitingReply   = Entry.Command;
+                ReplyDeadlineMs = Now + DFPLAYER_REPLY_TIMEOUT_MS;
+                break;
+            }
+
+            default :
+            {
+                break;
+            }
+        } // switch
+    } while (false);
+
+    // _ DEBUG_END;
+}  // Poll
+
+// -----------------------------------------------------------------------------
+bool c_DFPlayerAsync::IsPlayCommand (uint8_t Command)
+{
+    return( (CmdPlayTrack == Command) || (CmdPlayFolder == Command) || (CmdResume == Command) ||
+            (CmdNext == Command) || (CmdPrevious == Command) );
+}  // IsPlayCommand
+
+// -----------------------------------------------------------------------------
+uint16_t c_DFPlayerAsync::CalculateChecksum (const uint8_t* pFrame)
+{
+    uint16_t Sum = 0;
+
+    // version through parameter low byte
+    for (uint8_t Index = 1; Index < 7; ++Index)
+    {
+        Sum += pFrame[Index];
+    }
+
+    return( uint16_t (0 - Sum) );
+}  // CalculateChecksum
+
+// -----------------------------------------------------------------------------
+void c_DFPlayerAsync::SendFrame (uint8_t Command, uint16_t Parameter)
+{
+    // DEBUG_START;
+
+    uint8_t Frame[DFPLAYER_FRAME_SIZE];
+
+    Frame[0] = DFPLAYER_START_BYTE;
+    Frame[1] = DFPLAYER_VERSION;
+    Frame[2] = DFPLAYER_LENGTH;
+    Frame[3] = Command;
+    Frame[4] = 0;                                   // no ACK. The gap between commands is enough
+    Frame[5] = uint8_t (Parameter >> 8);
+    Frame[6] = uint8_t (Parameter);
+
+    uint16_t Checksum = CalculateChecksum (Frame);
+    Frame[7] = uint8_t (Checksum >> 8);
+    Frame[8] = uint8_t (Checksum);
+    Frame[9] = DFPLAYER_END_BYTE;
+
+    pPort->write (Frame, sizeof (Frame) );
+    ++TxFrames;
+
+    // DEBUG_END;
+}  // SendFrame
+
+// -----------------------------------------------------------------------------
+void c_DFPlayerAsync::ParseByte (uint8_t Data)
+{
+    // _ DEBUG_START;
+
+    // resync on anything that does not fit the fixed header
+    if ( (0 == RxIndex) && (DFPLAYER_START_BYTE != Data) )
+    {
+        ++RxErrors;
+        return;
+    }
+
+    if ( ( (1 == RxIndex) && (DFPLAYER_VERSION != Data) ) ||
+         ( (2 == RxIndex) && (DFPLAYER_LENGTH != Data) ) )
+    {
+        ++RxErrors;
+        RxIndex = (DFPLAYER_START_BYTE == Data) ? 1 : 0;
+        RxFrame[0] = Data;
+        return;
+    }
+
+    RxFrame[RxIndex++] = Data;
+
+    if (DFPLAYER_FRAME_SIZE > RxIndex)
+    {
+        return;
+    }
+
+    RxIndex = 0;
+
+    uint16_t Checksum = (uint16_t (RxFrame[7]) << 8) | RxFrame[8];
+
+    if ( (DFPLAYER_END_BYTE != RxFrame[9]) || ( CalculateChecksum (RxFrame) != Checksum) )
+    {
+        // DEBUG_V ("Bad frame");
+        ++RxErrors;
+        return;
+    }
+
+    ++RxFrames;
+    ProcessFrame ( RxFrame[3], (uint16_t (RxFrame[5]) << 8) | RxFrame[6] );
+
+    // _ DEBUG_END;
+}  // ParseByte
+
+// -----------------------------------------------------------------------------
+void c_DFPlayerAsync::ProcessFrame (uint8_t Command, uint16_t Parameter)
+{
+    // DEBUG_START;
+
+    // DEBUG_V (String ("Command: 0x") + String (Command, HEX) + " Parameter: " + String (Parameter));
+
+    if (Command == AwaitingReply)
+    {
+        AwaitingReply = 0;
+    }
+
+    if ( (NotifySdFinished == Command) || (NotifyUsbFinished == Command) )
+    {
+        uint32_t Now = millis ();
+
+        // The player sends every finished notification twice. A notification
+        // that shows up right after a play is for the track that play replaced.
+        // Either one would mark the new track stopped.
+        if ( ( (Parameter == LastFinishedTrack) && (DFPLAYER_FINISHED_REPEAT_MS > (Now - LastFinishedMs) ) ) ||
+             (DFPLAYER_PLAY_SETTLE_MS > (Now - LastPlaySentMs) ) )
+        {
+            ++IgnoredFinishes;
+            return;
+        }
+
+        LastFinishedMs = Now;
+    }
+
+    switch (Command)
+    {
+        case NotifySdFinished :
+        case NotifyUsbFinished :
+        {
+            LastFinishedTrack = Parameter;
+
+            // a play that is still queued will start the next track
+            if ( (PlayStatePlaying == PlayState) && (0 == QueuedPlays) )
+            {
+                PlayState = PlayStateStopped;
+            }
+            break;
+        }
+
+        case NotifyCardInserted :
+        case NotifyOnline :
+        {
+            CardOnline = true;
+            break;
+        }
+
+        case NotifyCardRemoved :
+        {
+            logcon ( F ("Card removed") );
+            CardOnline  = false;
+            FileCount   = -1;
+            PlayState   = PlayStateStopped;
+
+            for (int16_t & CurrentCount : FolderFileCount)
+            {
+                CurrentCount = -1;
+            }
+            break;
+        }
+
+        case NotifyError :
+        {
+            ++PlayerErrors;
+            LastError = Parameter;
+            logcon ( String ( F ("Error ") ) + String (Parameter) );
+
+            // the player answers a query for a folder that is not there with an error
+            if ( (QueryFolderFileCount == AwaitingReply) && (DFPLAYER_MAX_FOLDERS >= AwaitingFolder) )
+            {
+                FolderFileCount[AwaitingFolder] = 0;
+            }
+
+            // a query that failed is not going to be answered
+            AwaitingReply = 0;
+            break;
+        }
+
+        case QueryStatus :
+        {
+            // the low byte is the play state
+            uint8_t NewState = uint8_t (Parameter);
+            PlayState = (NewState <= PlayStatePaused) ? PlayState_t (NewState) : PlayStateUnknown;
+            break;
+        }
+
+        case QuerySdFileCount :
+        {
+            FileCount  = Parameter;
+            CardOnline = true;
+            break;
+        }
+
+        case QueryFolderFileCount :
+        {
+            if (DFPLAYER_MAX_FOLDERS >= AwaitingFolder)
+            {
+                FolderFileCount[AwaitingFolder] = int16_t (Parameter);
+            }
+            break;
+        }
+
+        case NotifyAck :
+        default :
+        {
+            break;
+        }
+    } // switch
+
+    if ( (nullptr != callback) && (NotifyCardInserted <= Command) && (NotifyError >= Command) )
+    {
+        (*callback)(context, Command, Parameter);
+    }
+
+    // DEBUG_END;
+}  // ProcessFrame
+
+// -----------------------------------------------------------------------------
+void c_DFPlayerAsync::GetStatus (JsonObject & json)
+{
+    // _ DEBUG_START;
+
+    json[F ("PlayState")]       = int (PlayState);
+    json[F ("FileCount")]       = FileCount;
+    json[F ("LastFinished")]    = LastFinishedTrack;
+    json[F ("LastError")]       = LastError;
+    json[F ("TxFrames")]        = TxFrames;
+    json[F ("RxFrames")]        = RxFrames;
+    json[F ("RxErrors")]        = RxErrors;
+    json[F ("ReplyTimeouts")]   = ReplyTimeouts;
+    json[F ("QueueOverflows")]  = QueueOverflows;
+    json[F ("PlayerErrors")]    = PlayerErrors;
+    json[F ("IgnoredFinishes")] = IgnoredFinishes;
+    json[F ("QueueDepth")]      = (QueueTail + DFPLAYER_QUEUE_SIZE - QueueHead) % DFPLAYER_QUEUE_SIZE;
+
+    // _ DEBUG_END;
+}  // GetStatus
@@ -0,0 +1,172 @@
+#pragma once
+/*
+ * DFPlayerAsync.hpp - Non blocking DFPlayer Mini protocol engine
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   Commands are queued and sent from Poll with the gap the player needs
+ *   between them. Replies are parsed a byte at a time as they arrive and end
+ *   up as cached state. Nothing in here waits on the UART.
+ *
+ *   Frame: 7E FF 06 CMD FB PH PL CKH CKL EF
+ *          checksum = 0 - (FF + 06 + CMD + FB + PH + PL)
+ *
+ */
+
+#include "JurasicParkGate.h"
+
+class c_DFPlayerAsync{
+public:
+
+c_DFPlayerAsync ();
+virtual ~c_DFPlayerAsync ();
+
+    #define DFPLAYER_FRAME_SIZE             10
+    #define DFPLAYER_QUEUE_SIZE             16
+    #define DFPLAYER_COMMAND_GAP_MS         30      // between two commands
+    #define DFPLAYER_RESET_GAP_MS           1500    // after a reset
+    #define DFPLAYER_REPLY_TIMEOUT_MS       500     // for a query reply
+    #define DFPLAYER_FINISHED_REPEAT_MS     1000    // the player reports a finished track twice
+    #define DFPLAYER_PLAY_SETTLE_MS         250     // finished notifications this soon after a play are for the old track
+    #define DFPLAYER_DEVICE_SD              2
+    #define DFPLAYER_EQ_NORMAL              0
+    #define DFPLAYER_MAX_FOLDERS            99      // folders 01 - 99
+
+// command and notification codes
+enum Command_t : uint8_t
+{
+    CmdNext             = 0x01,
+    CmdPrevious         = 0x02,
+    CmdPlayTrack        = 0x03,
+    CmdVolume           = 0x06,
+    CmdEq               = 0x07,
+    CmdOutputDevice     = 0x09,
+    CmdReset            = 0x0C,
+    CmdResume           = 0x0D,
+    CmdPause            = 0x0E,
+    CmdPlayFolder       = 0x0F,
+    CmdStop             = 0x16,
+
+    NotifyCardInserted  = 0x3A,
+    NotifyCardRemoved   = 0x3B,
+    NotifyUsbFinished   = 0x3C,
+    NotifySdFinished    = 0x3D,
+    NotifyOnline        = 0x3F,
+    NotifyError         = 0x40,
+    NotifyAck           = 0x41,
+
+    QueryStatus         = 0x42,
+    QuerySdFileCount    = 0x48,
+    QueryFolderFileCount = 0x4E,
+};
+
+// cached player state. Updated by the commands sent and the replies received
+enum PlayState_t : int8_t
+{
+    PlayStateUnknown = -1,
+    PlayStateStopped = 0,
+    PlayStatePlaying = 1,
+    PlayStatePaused  = 2,
+};
+
+void Begin      (Stream & Port);
+void Poll       ();                                 ///< Call from loop(). Sends queued commands and parses replies
+void GetStatus  (JsonObject & json);
+
+bool Enqueue    (uint8_t    Command,
+ uint16_t                   Parameter = 0);         ///< false if the queue is full
+
+// Called from Poll for every notification the player sends on its own
+// (Notify* codes). Parameter is the track, device or error code.
+void RegisterEventHandler (void (*    _callback)(void*, uint8_t, uint16_t),
+ void*                                _context) {callback = _callback; context = _context;}
+
+void PlayTrack      (uint16_t Track)                    {Enqueue (CmdPlayTrack, Track);}
+void PlayFolder     (uint8_t Folder, uint8_t File)      {Enqueue ( CmdPlayFolder, (uint16_t (Folder) << 8) | File );}
+void Pause          ()                                  {Enqueue (CmdPause);}
+void Resume         ()                                  {Enqueue (CmdResume);}
+void Stop           ()                                  {Enqueue (CmdStop);}
+void Next           ()                                  {Enqueue (CmdNext);}
+void Volume         (uint8_t Level)                     {Enqueue ( CmdVolume, min (Level, uint8_t (30) ) );}
+void Eq             (uint8_t Eq)                        {Enqueue (CmdEq, Eq);}
+void OutputDevice   (uint8_t Device)                    {Enqueue (CmdOutputDevice, Device);}
+void Reset          ()                                  {Enqueue (CmdReset);}
+void RequestStatus  ()                                  {Enqueue (QueryStatus);}
+void RequestFileCount ()                                {Enqueue (QuerySdFileCount);}
+void RequestFolderFileCount (uint8_t Folder)            {Enqueue (QueryFolderFileCount, Folder);}
+
+bool IsOnline       () {return(CardOnline);}
+bool IsIdle         () {return( (0 == QueuedPlays) && (PlayStatePlaying != PlayState) && (PlayStatePaused != PlayState) );}  ///< cached. Never touches the UART
+PlayState_t GetPlayState () {return(PlayState);}
+int32_t GetFileCount () {return(FileCount);}            ///< -1 until the player has answered
+int32_t GetFolderFileCount (uint8_t Folder) {return( ( (0 < Folder) && (DFPLAYER_MAX_FOLDERS >= Folder) ) ? FolderFileCount[Folder] : -1 );}  ///< -1 until the player has answered
+bool IsBusy         () {return( (QueueHead != QueueTail) || (0 != AwaitingReply) );}
+
+void GetDriverName  (String & Name) {Name = "DFPlayer";}
+
+private:
+
+struct QueueEntry_t
+{
+    uint8_t Command;
+    uint16_t Parameter;
+};
+
+void SendFrame      (uint8_t    Command,
+ uint16_t                       Parameter);
+void ParseByte      (uint8_t Data);
+void ProcessFrame   (uint8_t    Command,
+ uint16_t                       Parameter);
+static bool IsPlayCommand (uint8_t Command);
+static uint16_t CalculateChecksum (const uint8_t* pFrame);
+
+Stream* pPort = nullptr;
+void (* callback) (void*, uint8_t, uint16_t) = nullptr;
+void* context = nullptr;
+
+// transmit side
+QueueEntry_t Queue[DFPLAYER_QUEUE_SIZE];
+uint8_t QueueHead           = 0;                    // next entry to send
+uint8_t QueueTail           = 0;                    // next free entry
+uint32_t NextSendMs         = 0;                    // earliest time for the next command
+uint8_t AwaitingReply       = 0;                    // query that has not been answered yet
+uint32_t ReplyDeadlineMs    = 0;
+uint8_t AwaitingFolder      = 0;                    // folder of the last folder file count query
+uint8_t QueuedPlays         = 0;                    // play commands that have not been sent yet
+uint32_t LastPlaySentMs     = 0;
+
+// receive side
+uint8_t RxFrame[DFPLAYER_FRAME_SIZE];
+uint8_t RxIndex             = 0;
+
+// cached state
+PlayState_t PlayState       = PlayStateUnknown;
+bool CardOnline             = false;
+int32_t FileCount           = -1;
+int16_t FolderFileCount[DFPLAYER_MAX_FOLDERS + 1];  // -1 = not known
+uint16_t LastFinishedTrack  = 0;
+uint32_t LastFinishedMs     = 0;
+uint16_t LastError          = 0;
+
+// statistics
+uint32_t TxFrames           = 0;
+uint32_t RxFrames           = 0;
+uint32_t RxErrors           = 0;                    // framing or checksum
+uint32_t ReplyTimeouts      = 0;
+uint32_t QueueOverflows     = 0;
+uint32_t PlayerErrors       = 0;                    // error notifications from the player
+uint32_t IgnoredFinishes    = 0;                    // repeated or stale finished notifications
+
+}; // c_DFPlayerAsync
@@ -22,7 +22,11 @@
 #   include <driver/uart.h>
 #   include <driver/gpio.h>
 
+#include <algorithm>
 #include "GateAudio.hpp"
+#include "FileMgr.hpp"
+
+    #define GATE_AUDIO_CATALOG_DOC_SIZE     1024
 
 // -----------------------------------------------------------------------------
 ///< Start up the driver and put it into a safe mode
@@ -52,45 +56,394 @@ void c_GateAudio::Begin ()
          UART_PIN_NO_CHANGE,
          UART_PIN_NO_CHANGE) );
         Serial2.begin(9600, SERIAL_8N1, DEFAULT_UART_RX, DEFAULT_UART_TX, false);
-        Player.setTimeOut(1000); //Set serial communictaion time out
-        Player.begin(Serial2, false, false, true);
-        uint8_t PlayerType = Player.readType();
+        Player.Begin(Serial2);
+        Player.RegisterEventHandler(PlayerEventHandler, this);
+
+        Player.Volume(10);  //Set volume value. From 0 to 30
+        Player.Eq(DFPLAYER_EQ_NORMAL);
+        Player.OutputDevice(DFPLAYER_DEVICE_SD);
+
+        // With a saved catalogue the gate can play right away. Poll checks it
+        // against the card in the background (see ValidateCatalog)
+        LoadCatalog();
+        RestartValidation(millis());
+        Player.RequestFileCount();
+
+    } while (false);
+
+    // DEBUG_END;
+}  // begin
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::Poll ()
+{
+    // _ DEBUG_START;
+
+    do  // once
+    {
+        Player.Poll();
+        Playlist.Poll();
 
-        // DEBUG_V(String("command: ") + String(Player._handleCommand, HEX));
-        // DEBUG_V(String("PlayerType: ") + String(PlayerType, HEX));
-        if(DFPlayerCardOnline != PlayerType)
+        if(IsInstalled && !PlaylistStarted)
         {
-            // readType() != DFPlayerCardOnline
-            logcon( String( F("Failed to init the MP3 player. Error: ") ) + String( Player.readType() ) );
+            PlaylistStarted = true;
+            Playlist.Begin(uint32_t(Catalog.Files), Catalog.Folders);
+        }
+
+        if(PendingFinish)
+        {
+            PendingFinish = false;
+            TrackFinished();
+        }
+
+        // the gate asked for a track while there was nothing to play
+        if(PlayRequested && IsInstalled)
+        {
+            PlayNextTrack();
+        }
+
+        // the status reply says the track is over but the notification got lost
+        if(AwaitingFinish && (c_DFPlayerAsync::PlayStateStopped == Player.GetPlayState()) && Player.IsIdle())
+        {
+            // DEBUG_V("Track ended without a notification");
+            TrackFinished();
+        }
+
+        if(Player.IsBusy())
+        {
+            break;
+        }
+
+        uint32_t now = millis();
+
+        if(CatalogValid != CatalogState)
+        {
+            ValidateCatalog(now);
+        }
+
+        if(!IsInstalled)
+        {
+            break;
+        }
+
+        // keep the cached play state honest while something is playing
+        if(!Player.IsIdle() && (GATE_AUDIO_STATUS_INTERVAL_MS <= (now - LastRequestMs)))
+        {
+            LastRequestMs = now;
+            Player.RequestStatus();
+        }
+
+    } while (false);
+
+    // _ DEBUG_END;
+}  // Poll
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::PlayerEventHandler (void* context, uint8_t Event, uint16_t /* Parameter */)
+{
+    // none of the events used here carry a useful parameter
+    if(context)
+    {
+        static_cast <c_GateAudio*> (context)->ProcessPlayerEvent(Event);
+    }
+} // PlayerEventHandler
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::ProcessPlayerEvent (uint8_t Event)
+{
+    // DEBUG_START;
+
+    // DEBUG_V(String("Event: 0x") + String(Event, HEX));
+
+    uint32_t now = millis();
+
+    switch (Event)
+    {
+        case c_DFPlayerAsync::NotifySdFinished :
+        case c_DFPlayerAsync::NotifyUsbFinished :
+        {
+            // repeats are dropped by the player driver
+            TrackFinished();
+            break;
+        }
+
+        case c_DFPlayerAsync::NotifyCardRemoved :
+        {
+            // Poll looks for the card again. A track that was cut off is
+            // started again once the card is back
             IsInstalled = false;
+            PlayRequested = PlayRequested || AwaitingFinish;
+            AwaitingFinish = false;
+            RestartValidation(now);
+
+            if(callback)
+            {
+                (*callback)(context, AudioEventCardRemoved);
+            }
             break;
         }
 
+        case c_DFPlayerAsync::NotifyError :
+        {
+            // A track that failed to start is picked up by the status check in Poll
+            if(callback)
+            {
+                (*callback)(context, AudioEventError);
+            }
+            break;
+        }
+
+        default :
+        {
+            break;
+        }
+    } // switch
+
+    // DEBUG_END;
+} // ProcessPlayerEvent
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::TrackFinished ()
+{
+    // DEBUG_START;
+
+    // only one finish per track that was started
+    if(AwaitingFinish)
+    {
+        AwaitingFinish = false;
+
+        if(callback)
+        {
+            (*callback)(context, AudioEventTrackFinished);
+        }
+    }
+
+    // DEBUG_END;
+} // TrackFinished
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::RestartValidation (uint32_t now)
+{
+    // DEBUG_START;
+
+    if(CatalogValid == CatalogState)
+    {
+        CatalogState = CatalogCached;
+    }
+
+    FolderCountsRequested = false;
+    ValidateStartMs = now;
+    LastRequestMs = now;
+
+    // DEBUG_END;
+} // RestartValidation
+
+// -----------------------------------------------------------------------------
+///< Compare what the player reports with the catalogue. Runs from Poll and
+///< never waits on the player. The intro folder and the playlist folders are
+///< counted once the player has reported its total file count.
+void c_GateAudio::ValidateCatalog (uint32_t now)
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        int32_t Files = Player.GetFileCount();
+
+        if(0 > Files)
+        {
+            // the cached catalogue let the gate play without the player. Stop doing that
+            if(IsInstalled && (GATE_AUDIO_VALIDATE_TIMEOUT_MS <= (now - ValidateStartMs)))
+            {
+                logcon( F("Player did not answer. Not using the saved catalogue") );
+                IsInstalled = false;
+
+                if(AwaitingFinish)
+                {
+                    PendingFinish = true;
+                }
+            }
+
+            if(GATE_AUDIO_DETECT_INTERVAL_MS <= (now - LastRequestMs))
+            {
+                // DEBUG_V("Ask the player for its file count");
+                LastRequestMs = now;
+                Player.RequestFileCount();
+            }
+            break;
+        }
+
+        std::vector <uint8_t> FolderList;
+        Playlist.GetFolders(FolderList);
+
+        if(FolderList.end() == std::find(FolderList.begin(), FolderList.end(), GATE_AUDIO_INTRO_FOLDER))
+        {
+            FolderList.push_back(GATE_AUDIO_INTRO_FOLDER);
+        }
+
+        if(!FolderCountsRequested)
+        {
+            for (auto CurrentFolder : FolderList)
+            {
+                Player.RequestFolderFileCount(CurrentFolder);
+            }
+            FolderCountsRequested = true;
+
+            // the answers are in once the player queue has drained
+            break;
+        }
+
+        Catalog_t NewCatalog;
+        NewCatalog.Files = Files;
+
+        for (auto CurrentFolder : FolderList)
+        {
+            // a folder that did not answer is treated as empty
+            int32_t FolderFiles = Player.GetFolderFileCount(CurrentFolder);
+            NewCatalog.Folders.push_back( {CurrentFolder, uint16_t( max(FolderFiles, int32_t(0)) )} );
+        }
+
+        NewCatalog.Id = CalculateCatalogId(NewCatalog);
+
+        logcon( String( F("Player NumFiles: ") ) + String(Files) );
+
+        if((CatalogNone == CatalogState) || (NewCatalog.Id != Catalog.Id))
+        {
+            if(CatalogNone != CatalogState)
+            {
+                logcon( F("Card catalogue changed. Rebuilding the playlist") );
+                ++CatalogRebuilds;
+            }
+
+            Catalog = NewCatalog;
+            SaveCatalog();
+            PlaylistStarted = false;
+        }
+
+        CatalogState = CatalogValid;
         IsInstalled = true;
 
-        Player.setTimeOut(500); //Set serial communictaion time out
+    } while (false);
+
+    // DEBUG_END;
+} // ValidateCatalog
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::LoadCatalog ()
+{
+    // DEBUG_START;
+
+    DynamicJsonDocument CatalogDoc(GATE_AUDIO_CATALOG_DOC_SIZE);
 
-        // Player.volume(10);  //Set volume value (0~30).
-        Player.volume(10);  //Set volume value. From 0 to 30
-        Player.EQ(DFPLAYER_EQ_NORMAL);
-        Player.outputDevice(DFPLAYER_DEVICE_SD);
+    do  // once
+    {
+        if(!FileMgr.ReadConfigFile(GATE_AUDIO_CATALOG_FILE_NAME, CatalogDoc))
+        {
+            logcon( F("No saved audio catalogue. Waiting for the player") );
+            break;
+        }
+
+        Catalog_t SavedCatalog;
+        setFromJSON(SavedCatalog.Files, CatalogDoc, F("files"));
+        setFromJSON(SavedCatalog.Id,    CatalogDoc, F("id"));
 
-        uint32_t NumFiles = Player.readFileCounts(DFPLAYER_DEVICE_SD);
-        logcon( String( F("Player NumFiles: ") ) + String(NumFiles) );
-        SongList.reserve(NumFiles);
+        JsonArray JsonFolders = CatalogDoc[F("folders")];
 
-        for(int index = 0; index < NumFiles; ++index)
+        for (JsonArray JsonFolder : JsonFolders)
         {
-            SongInfo_t NewSong;
-            NewSong.ReadyToPlay = true;
-            NewSong.SongId = index + 1;
-            SongList.push_back(NewSong);
+            if(2 == JsonFolder.size())
+            {
+                SavedCatalog.Folders.push_back( {JsonFolder[0], JsonFolder[1]} );
+            }
         }
 
+        // the id doubles as a check that the file is intact
+        if((0 > SavedCatalog.Files) || (SavedCatalog.Id != CalculateCatalogId(SavedCatalog)))
+        {
+            logcon( F("Saved audio catalogue is not usable. Waiting for the player") );
+            break;
+        }
+
+        Catalog = SavedCatalog;
+        CatalogState = CatalogCached;
+
+        // The playlist is started from Poll once the gate config has been applied
+        logcon( String( F("Using saved audio catalogue. NumFiles: ") ) + String(Catalog.Files) );
+        IsInstalled = true;
+
     } while (false);
 
     // DEBUG_END;
-}  // begin
+} // LoadCatalog
+
+// -----------------------------------------------------------------------------
+void c_GateAudio::SaveCatalog ()
+{
+    // DEBUG_START;
+
+    DynamicJsonDocument CatalogDoc(GATE_AUDIO_CATALOG_DOC_SIZE);
+
+    CatalogDoc[F("files")] = Catalog.Files;
+    CatalogDoc[F("id")]    = Catalog.Id;
+
+    JsonArray JsonFolders = CatalogDoc.createNestedArray(F("folders"));
+
+    for (auto & CurrentFolder : Catalog.Folders)
+    {
+        JsonArray JsonFolder = JsonFolders.createNestedArray();
+        JsonFolder.add(CurrentFolder.Folder);
+        JsonFolder.add(CurrentFolder.Files);
+    }
+
+    FileMgr.SaveConfigFile(GATE_AUDIO_CATALOG_FILE_NAME, CatalogDoc);
+
+    // DEBUG_END;
+} // SaveCatalog
+
+// -----------------------------------------------------------------------------
+///< -1 if the folder is not in the catalogue
+int32_t c_GateAudio::GetCatalogFolderFiles (uint8_t Folder)
+{
+    int32_t response = -1;
+
+    for (auto & CurrentFolder : Catalog.Folders)
+    {
+        if(Folder == CurrentFolder.Folder)
+        {
+            response = CurrentFolder.Files;
+            break;
+        }
+    }
+
+    return(response);
+} // GetCatalogFolderFiles
+
+// -----------------------------------------------------------------------------
+///< FNV-1a over the file counts
+uint32_t c_GateAudio::CalculateCatalogId (const Catalog_t & Catalog)
+{
+    uint32_t Hash = 2166136261UL;
+
+    auto AddByte = [&Hash](uint8_t Data)
+    {
+        Hash ^= Data;
+        Hash *= 16777619UL;
+    };
+
+    for (uint32_t shift = 0; shift < 32; shift += 8)
+    {
+        AddByte(uint8_t(uint32_t(Catalog.Files) >> shift));
+    }
+
+    for (auto & CurrentFolder : Catalog.Folders)
+    {
+        AddByte(CurrentFolder.Folder);
+        AddByte(uint8_t(CurrentFolder.Files));
+        AddByte(uint8_t(CurrentFolder.Files >> 8));
+    }
+
+    return(Hash);
+} // CalculateCatalogId
 
 // -----------------------------------------------------------------------------
 bool c_GateAudio::SetConfig (JsonObject & json)
@@ -101,7 +454,12 @@ bool c_GateAudio::SetConfig (JsonObject & json)
 
     JsonObject  jsonMp3 = json[CN_MP3];
 
-    setFromJSON(randomize, jsonMp3, CN_randomize);
+    if(Playlist.SetConfig(jsonMp3))
+    {
+        // count the files in any new playlist folder
+        ConfigChanged = true;
+        RestartValidation(millis());
+    }
 
     // DEBUG_END;
 
@@ -114,7 +472,7 @@ void c_GateAudio::GetConfig (JsonObject & json)
     // DEBUG_START;
 
     JsonObject jsonMp3 = json.createNestedObject(CN_MP3);
-    jsonMp3[CN_randomize]  = randomize;
+    Playlist.GetConfig(jsonMp3);
 
     // DEBUG_END;
 }  // GetConfig
@@ -125,7 +483,17 @@ void c_GateAudio::GetStatus (JsonObject & json)
     // _ DEBUG_START;
     JsonObject jsonMp3 = json.createNestedObject(CN_MP3);
     jsonMp3[F ("installed")] = IsInstalled;
-    jsonMp3[F ("LastPlayerStatus")] = LastPlayerStatus;
+    jsonMp3[F ("LastPlayerStatus")] = int(Player.GetPlayState());
+
+    JsonObject jsonCatalog = jsonMp3.createNestedObject(F ("catalog"));
+    jsonCatalog[F ("state")] = (CatalogValid == CatalogState) ? F ("valid") : (CatalogCached == CatalogState) ? F ("cached") : F ("none");
+    jsonCatalog[F ("files")] = Catalog.Files;
+    jsonCatalog[F ("id")] = Catalog.Id;
+    jsonCatalog[F ("rebuilds")] = CatalogRebuilds;
+
+    JsonObject jsonPlayer = jsonMp3.createNestedObject(F ("player"));
+    Player.GetStatus(jsonPlayer);
+    Playlist.GetStatus(jsonMp3);
 
     if( IsIdle() )
     {
@@ -133,7 +501,8 @@ void c_GateAudio::GetStatus (JsonObject & json)
     }
     else
     {
-        jsonMp3[F ("playing")] = LastFilePlayed;
+        jsonMp3[F ("playing")] = LastTrackPlayed.File;
+        jsonMp3[F ("folder")] = LastTrackPlayed.Folder;
     }
 
     // _ DEBUG_END;
@@ -144,9 +513,17 @@ void c_GateAudio::PlayIntro ()
 {
     // DEBUG_START;
 
-    if(IsInstalled)
+    AwaitingFinish = true;
+
+    // an empty intro folder would never report a finish
+    if(IsInstalled && (0 != GetCatalogFolderFiles(GATE_AUDIO_INTRO_FOLDER)))
+    {
+        Player.PlayFolder(GATE_AUDIO_INTRO_FOLDER, GATE_AUDIO_INTRO_FILE);
+    }
+    else
     {
-        Player.playFolder(2,1);
+        // nothing to wait for. Let the gate move on
+        PendingFinish = true;
     }
 
     // DEBUG_END;
@@ -156,10 +533,7 @@ void c_GateAudio::PlayIntro ()
 void c_GateAudio::PlayCurrentSelection ()
 {
     // DEBUG_START;
-    if(IsInstalled)
-    {
-        Player.play( getNextFileToPlay() );
-    }
+    PlayNextTrack();
 
     // DEBUG_END;
 }  // PlayCurrentSelection
@@ -169,9 +543,11 @@ void c_GateAudio::PausePlaying ()
 {
     // DEBUG_START;
 
+    PlayRequested = false;
+
     if(IsInstalled)
     {
-        Player.pause();
+        Player.Pause();
     }
 
     // DEBUG_END;
@@ -182,9 +558,12 @@ void c_GateAudio::StopPlaying ()
 {
     // DEBUG_START;
 
+    PlayRequested = false;
+
     if(IsInstalled)
     {
-        Player.stop();
+        AwaitingFinish = false;
+        Player.Stop();
     }
 
     // DEBUG_END;
@@ -194,10 +573,7 @@ void c_GateAudio::StopPlaying ()
 void c_GateAudio::NextSong ()
 {
     // DEBUG_START;
-    if(IsInstalled)
-    {
-        Player.play( getNextFileToPlay() );
-    }
+    PlayNextTrack();
 
     // DEBUG_END;
 }  // NextSong
@@ -209,7 +585,7 @@ void c_GateAudio::ResumePlaying ()
 
     if(IsInstalled)
     {
-        Player.start();
+        Player.Resume();
     }
 
     // DEBUG_END;
@@ -220,252 +596,49 @@ bool c_GateAudio::IsIdle ()
 {
     // _ DEBUG_START;
 
-    if(IsInstalled)
-    {
-        int newPlayerStatus = Player.readState();
-        printDetail( Player.readType(), Player.read() ); //Print the detail message from DFPlayer to handle different errors and states.
+    // cached by the player driver. Does not wait on the UART
+    bool response = true;
 
-        if(-1 != newPlayerStatus) // ignore failed status reads
-        {
-            if(LastPlayerStatus != newPlayerStatus)
-            {
-                // DEBUG_V(String("newPlayerStatus: ") + String(newPlayerStatus));
-            }
-            LastPlayerStatus = newPlayerStatus;
-        }
-    }
-    else
+    if(IsInstalled)
     {
-        // show we are idle
-        LastPlayerStatus = 0;
+        response = Player.IsIdle();
     }
 
     // _ DEBUG_END;
 
-    return(0 == LastPlayerStatus);
-}  // ResumePlaying
+    return(response);
+}  // IsIdle
 
 // -----------------------------------------------------------------------------
-void c_GateAudio::printDetail(uint8_t type, int value)
+void c_GateAudio::PlayNextTrack()
 {
-    return;
-
     // DEBUG_START;
-    switch (type)
-    {
-    case TimeOut :
-    {
-        logcon( F("Time Out!") );
-        break;
-    }
 
-    case WrongStack :
-    {
-        logcon( F("Stack Wrong!") );
-        break;
-    }
+    c_GatePlaylist::Track_t Track;
 
-    case DFPlayerCardInserted :
-    {
-        logcon( F("Card Inserted!") );
-        break;
-    }
+    // without a track there is no finish to report. Poll tries again
+    PlayRequested = true;
 
-    case DFPlayerCardRemoved :
+    if(IsInstalled && Playlist.Next(Track))
     {
-        logcon( F("Card Removed!") );
-        break;
-    }
+        PlayRequested = false;
+        AwaitingFinish = true;
+        LastTrackPlayed = Track;
 
-    case DFPlayerCardOnline :
-    {
-        logcon( F("Card Online!") );
-        break;
-    }
-
-    case DFPlayerUSBInserted :
-    {
-        logcon("USB Inserted!");
-        break;
-    }
-
-    case DFPlayerUSBRemoved :
-    {
-        logcon("USB Removed!");
-        break;
-    }
-
-    case DFPlayerPlayFinished :
-    {
-        logcon( String( F("Number:") ) + String(value) );
-        logcon( F(" Play Finished!") );
-        break;
-    }
-
-    case DFPlayerFeedBack :
-    {
-        logcon( F(" Player Feedback!") );
-        logcon( String( F("value: ") ) + String(value) );
-        break;
-    }
-
-    case DFPlayerError :
-    {
-        logcon( F("DFPlayerError:") );
-        switch (value)
-        {
-        case Busy :
-        {
-            logcon( F("Card not found") );
-            break;
-        }
-
-        case Sleeping :
-        {
-            logcon( F("Sleeping") );
-            break;
-        }
-
-        case SerialWrongStack :
-        {
-            logcon( F("Get Wrong Stack") );
-            break;
-        }
-
-        case CheckSumNotMatch :
-        {
-            logcon( F("Check Sum Not Match") );
-            break;
-        }
-
-        case FileIndexOut :
-        {
-            logcon( F("File Index Out of Bound") );
-            break;
-        }
-
-        case FileMismatch :
-        {
-            logcon( F("Cannot Find File") );
-            break;
-        }
-
-        case Advertise :
-        {
-            logcon( F("In Advertise") );
-            break;
-        }
-
-        default :
-        {
-            logcon( String( F("type: value") ) + String(value) );
-            break;
-        }
-        } // switch
-        break;
-    }
-
-    default :
-    {
-        logcon( String( F(" type: ") ) + String(type) );
-        logcon( String( F("value: ") ) + String(value) );
-        break;
-    }
-    } // switch
-      // DEBUG_END;
-} // c_GateAudio::printDetail
-
-// -----------------------------------------------------------------------------
-uint32_t c_GateAudio::getNextFileToPlay()
-{
-    // DEBUG_START;
-
-    uint32_t    SongToPlay = LastFilePlayed;
-
-    if(!randomize)
-    {
-        // DEBUG_V("Not Randomizing");
-        if( (SongToPlay >= SongList.size()) || (SongToPlay == 0) )
+        if(0 == Track.Folder)
         {
-            SongToPlay = SongList[0].SongId;
+            Player.PlayTrack(Track.File);
+            logcon( String("Playing: ") + String(Track.File) );
         }
-    }
-    else
-    {
-        uint32_t    NumPlayableSongs = GetNumPlayableSongs();
-        if(0 == NumPlayableSongs)
-        {
-            NumPlayableSongs = RefreshPlayList();
-        }
-
-        uint32_t selector = random(1, NumPlayableSongs);
-        // DEBUG_V( String("selector: ") + String(selector) );
-
-        if(selector)
-        {
-            for(auto & currentSong : SongList)
-            {
-                // is the entry available?
-                if(currentSong.ReadyToPlay)
-                {
-                    if(0 == --selector)
-                    {
-                        // DEBUG_V("found the song to play");
-                        SongToPlay = currentSong.SongId;
-                        currentSong.ReadyToPlay = false;
-                        break;
-                    }
-                }
-            }
-        }
-    }
-
-    if(SongToPlay == 0)
-    {
-        uint32_t dumpId = 0;
-        for(auto currentSong : SongList)
+        else
         {
-            // DEBUG_V( String(currentSong.SongId) + ": " + String(currentSong.ReadyToPlay) );
+            Player.PlayFolder(Track.Folder, Track.File);
+            logcon( String("Playing: ") + String(Track.Folder) + "/" + String(Track.File) );
         }
     }
 
-    LastFilePlayed = SongToPlay;
-    logcon( String("Playing: ") + String(SongToPlay) );
-    // DEBUG_END;
-    return(SongToPlay);
-
-} // getNextFileToPlay
-
-// -----------------------------------------------------------------------------
-uint32_t c_GateAudio::GetNumPlayableSongs()
-{
-    // DEBUG_START;
-    uint32_t response = 0;
-
-    for(auto & currentSong : SongList)
-    {
-        if(currentSong.ReadyToPlay) {++response;}
-    }
-    // DEBUG_V( String("Num Playable Songs: ") + String(response) );
-
-    // DEBUG_END;
-    return(response);
-
-} // GetNumPlayableSongs
-
-// -----------------------------------------------------------------------------
-uint32_t c_GateAudio::RefreshPlayList()
-{
-    // DEBUG_START;
-
-    for(auto & currentSong : SongList)
-    {
-        currentSong.ReadyToPlay = true;
-    }
-
     // DEBUG_END;
-    return( SongList.size() );
-} // RefreshPlayList
+} // PlayNextTrack
 
 // create a global instance of the Gate Audio
 c_GateAudio GateAudio;
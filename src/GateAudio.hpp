@@ -19,30 +19,65 @@
  */
 
 #include "JurasicParkGate.h"
-#include "DFRobotDFPlayerMini.h"
-#include <vector>
+#include "DFPlayerAsync.hpp"
+#include "GatePlaylist.hpp"
 class c_GateAudio{
 private:
-void printDetail(uint8_t    type,
- int                        value);
-uint32_t getNextFileToPlay();
-uint32_t GetNumPlayableSongs();
-uint32_t RefreshPlayList();
-uint32_t LastFilePlayed = 0;
+void PlayNextTrack();
+c_GatePlaylist::Track_t LastTrackPlayed = {0, 0};
 
-DFRobotDFPlayerMini Player;
+    #define GATE_AUDIO_DETECT_INTERVAL_MS   2000    // between file count requests while the player is missing
+    #define GATE_AUDIO_STATUS_INTERVAL_MS   1000    // between status requests while playing
+    #define GATE_AUDIO_VALIDATE_TIMEOUT_MS  10000   // to confirm a cached catalogue
+    #define GATE_AUDIO_CATALOG_FILE_NAME    "/audiocatalog.json"
+    #define GATE_AUDIO_INTRO_FOLDER         2
+    #define GATE_AUDIO_INTRO_FILE           1
+
+c_DFPlayerAsync Player;
+c_GatePlaylist Playlist;
 bool IsInstalled = false;
-bool randomize = true;
-int LastPlayerStatus = -1;
+uint32_t LastRequestMs = 0;
 
-protected:
-struct SongInfo_t
+// What is on the card. Saved so that the gate can play right after a boot
+// instead of waiting for the player to answer. The player has no card serial
+// number so the identity is a hash of the file counts.
+struct Catalog_t
+{
+    int32_t Files = -1;                     // -1 = nothing known
+    std::vector <c_GatePlaylist::FolderFiles_t> Folders;
+    uint32_t Id = 0;
+};
+enum CatalogState_t
 {
-    uint32_t SongId;
-    bool ReadyToPlay;
+    CatalogNone = 0,                        // nothing known about the card
+    CatalogCached,                          // using the saved catalogue. Not checked yet
+    CatalogValid,                           // the player agrees
 };
+Catalog_t Catalog;
+CatalogState_t CatalogState = CatalogNone;
+bool FolderCountsRequested = false;
+bool PlaylistStarted = false;
+uint32_t ValidateStartMs = 0;
+uint32_t CatalogRebuilds = 0;
+
+void LoadCatalog();
+void SaveCatalog();
+void ValidateCatalog(uint32_t now);
+void RestartValidation(uint32_t now);
+int32_t GetCatalogFolderFiles(uint8_t Folder);
+static uint32_t CalculateCatalogId(const Catalog_t & Catalog);
 
-std::vector<SongInfo_t> SongList;
+// events
+static void PlayerEventHandler(void*    context,
+ uint8_t                                Event,
+ uint16_t                               Parameter);
+void ProcessPlayerEvent(uint8_t Event);
+void TrackFinished();
+bool AwaitingFinish = false;                // a track was started and has not finished yet
+bool PendingFinish = false;                 // report a finish on the next poll
+bool PlayRequested = false;                 // a track was asked for but could not be started
+void (* callback) (void*, uint8_t) = nullptr;
+void* context = nullptr;
 
 public:
 
@@ -50,7 +85,7 @@ c_GateAudio ();
 virtual ~c_GateAudio ();
 
 void Begin     ();
-void Poll      () {}
+void Poll      ();
 void GetConfig (JsonObject & json);
 bool SetConfig (JsonObject & json);
 void GetStatus (JsonObject & json);
@@ -63,6 +98,17 @@ void StopPlaying();
 void NextSong();
 bool IsIdle();
 
+// unsolicited player events passed on to the gate
+enum AudioEvent_t
+{
+    AudioEventTrackFinished = 0,
+    AudioEventCardRemoved,
+    AudioEventError,
+};
+
+void RegisterEventHandler(void (*  _callback)(void*, uint8_t),
+ void*                             _context) {callback = _callback; context = _context;}
+
 void GetDriverName    (String & Name) {Name = "GateAudio";}
 
 }; // c_GateAudio
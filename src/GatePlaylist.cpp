@@ -0,0 +1,545 @@
+/*
+ * GatePlaylist.cpp - Shuffled play order for the gate audio
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "GatePlaylist.hpp"
+#include "FileMgr.hpp"
+
+// seed, cursor, size, shuffle, recent and deferred. Each track in the two
+// lists is a [folder, file] pair. The key names are copied into the document,
+// which needs the slack
+    #define GATE_PLAYLIST_STATE_KEYS        6
+    #define GATE_PLAYLIST_STATE_DOC_SIZE    (JSON_OBJECT_SIZE (GATE_PLAYLIST_STATE_KEYS) + \
+                                             (2 * JSON_ARRAY_SIZE (GATE_PLAYLIST_MAX_NO_REPEAT) ) + \
+                                             (2 * GATE_PLAYLIST_MAX_NO_REPEAT * JSON_ARRAY_SIZE (2) ) + \
+                                             128)
+
+// -----------------------------------------------------------------------------
+c_GatePlaylist::c_GatePlaylist ()
+{}   // c_GatePlaylist
+
+// -----------------------------------------------------------------------------
+c_GatePlaylist::~c_GatePlaylist ()
+{
+    // DEBUG_START;
+
+    // DEBUG_END;
+}  // ~c_GatePlaylist
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::Begin (uint32_t _NumFilesOnCard, const std::vector <FolderFiles_t> & _FolderFilesOnCard)
+{
+    // DEBUG_START;
+
+    NumFilesOnCard    = _NumFilesOnCard;
+    FolderFilesOnCard = _FolderFilesOnCard;
+    LoadState ();
+
+    // DEBUG_END;
+}  // Begin
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::Poll ()
+{
+    // _ DEBUG_START;
+
+    if ( StateIsDirty && (GATE_PLAYLIST_SAVE_INTERVAL_MS <= (millis () - LastSaveMs) ) )
+    {
+        SaveState ();
+    }
+
+    // _ DEBUG_END;
+}  // Poll
+
+// -----------------------------------------------------------------------------
+bool c_GatePlaylist::SetConfig (JsonObject & json)
+{
+    // DEBUG_START;
+
+    bool ConfigChanged = false;
+
+    ConfigChanged |= setFromJSON (Shuffle, json, CN_randomize);
+    if (setFromJSON (NoRepeat, json, GATE_PLAYLIST_NO_REPEAT_NAME) )
+    {
+        NoRepeat      = min (NoRepeat, uint32_t (GATE_PLAYLIST_MAX_NO_REPEAT) );
+        RecentCount   = 0;
+        RecentIndex   = 0;
+        DeferredCount = 0;
+        ConfigChanged = true;
+    }
+
+    if (json.containsKey (GATE_PLAYLIST_FOLDERS_NAME) )
+    {
+        std::vector <FolderConfig_t> NewFolders;
+        JsonArray   JsonFolders = json[GATE_PLAYLIST_FOLDERS_NAME];
+
+        for (JsonObject JsonFolder : JsonFolders)
+        {
+            FolderConfig_t NewFolder = {0, 0, 1};
+            setFromJSON (NewFolder.Folder,  JsonFolder, GATE_PLAYLIST_FOLDER_NAME);
+            setFromJSON (NewFolder.Files,   JsonFolder, GATE_PLAYLIST_FILES_NAME);
+            setFromJSON (NewFolder.Weight,  JsonFolder, GATE_PLAYLIST_WEIGHT_NAME);
+
+            // folder 0 is not a folder on the card. Files 0 means all of them
+            if ( (0 == NewFolder.Folder) || (0 == NewFolder.Weight) )
+            {
+                continue;
+            }
+
+            NewFolder.Weight = min (NewFolder.Weight, uint8_t (GATE_PLAYLIST_MAX_WEIGHT) );
+            NewFolders.push_back (NewFolder);
+        }
+
+        bool FoldersChanged = (NewFolders.size () != Folders.size () );
+
+        for (uint32_t index = 0; !FoldersChanged && (index < Folders.size () ); ++index)
+        {
+            FoldersChanged = (NewFolders[index].Folder != Folders[index].Folder) ||
+                             (NewFolders[index].Files != Folders[index].Files) ||
+                             (NewFolders[index].Weight != Folders[index].Weight);
+        }
+
+        if (FoldersChanged)
+        {
+            Folders         = NewFolders;
+            ConfigChanged   = true;
+        }
+    }
+
+    // start a new rotation with the new rules
+    if (ConfigChanged && !Deck.empty () )
+    {
+        DeckSeed      = esp_random ();
+        DeferredCount = 0;
+        ShuffleDeck ();
+    }
+
+    // DEBUG_END;
+    return(ConfigChanged);
+}  // SetConfig
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::GetConfig (JsonObject & json)
+{
+    // DEBUG_START;
+
+    json[CN_randomize]                  = Shuffle;
+    json[GATE_PLAYLIST_NO_REPEAT_NAME]  = NoRepeat;
+
+    JsonArray JsonFolders = json.createNestedArray (GATE_PLAYLIST_FOLDERS_NAME);
+
+    for (auto & CurrentFolder : Folders)
+    {
+        JsonObject JsonFolder = JsonFolders.createNestedObject ();
+        JsonFolder[GATE_PLAYLIST_FOLDER_NAME]   = CurrentFolder.Folder;
+        JsonFolder[GATE_PLAYLIST_FILES_NAME]    = CurrentFolder.Files;
+        JsonFolder[GATE_PLAYLIST_WEIGHT_NAME]   = CurrentFolder.Weight;
+    }
+
+    // DEBUG_END;
+}  // GetConfig
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::GetStatus (JsonObject & json)
+{
+    // _ DEBUG_START;
+
+    JsonObject jsonPlaylist = json.createNestedObject (F ("playlist"));
+
+    jsonPlaylist[F ("size")]            = Deck.size ();
+    jsonPlaylist[F ("cursor")]          = Cursor;
+    jsonPlaylist[F ("seed")]            = DeckSeed;
+    jsonPlaylist[F ("reshuffles")]      = Reshuffles;
+    jsonPlaylist[F ("repeatsavoided")]  = RepeatsAvoided;
+    jsonPlaylist[F ("deferred")]        = DeferredCount;
+
+    // _ DEBUG_END;
+}  // GetStatus
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::SetShuffle (bool _Shuffle)
+{
+    // DEBUG_START;
+
+    if (_Shuffle != Shuffle)
+    {
+        Shuffle = _Shuffle;
+
+        if (!Deck.empty () )
+        {
+            DeckSeed      = esp_random ();
+            DeferredCount = 0;
+            ShuffleDeck ();
+        }
+    }
+
+    // DEBUG_END;
+}  // SetShuffle
+
+// -----------------------------------------------------------------------------
+bool c_GatePlaylist::Next (Track_t & Track)
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do  // once
+    {
+        if (Deck.empty () )
+        {
+            break;
+        }
+
+        Response = true;
+
+        // a track that was put off goes first once it has not been played recently
+        uint32_t Oldest    = 0;
+        uint32_t OldestAge = 0;
+
+        for (uint32_t index = 0; index < DeferredCount; ++index)
+        {
+            uint32_t Age = PlaysSince (Deferred[index]);
+
+            if (Age > OldestAge)
+            {
+                Oldest    = index;
+                OldestAge = Age;
+            }
+        }
+
+        // The weights can ask for more repeats than NoRepeat allows. The list
+        // then keeps growing, so it is drained at the end of the deck instead
+        // of being left to fill up.
+        if ( (OldestAge > RecentCount) ||
+             ( (Cursor >= Deck.size () ) && ( DeferredCount >= (GATE_PLAYLIST_MAX_NO_REPEAT / 2) ) ) )
+        {
+            TakeDeferred (Oldest, Track);
+            break;
+        }
+
+        if (Cursor >= Deck.size () )
+        {
+            // the seed of the next deck comes from this one so that the
+            // whole rotation follows from the first seed
+            DeckSeed = Random.Next ();
+            ShuffleDeck ();
+            ++Reshuffles;
+        }
+
+        // Look forward for something not played recently. Each recent track is
+        // in the deck at most weight times so this is a short walk, except at
+        // the very end of a deck where every remaining track may be recent.
+        // The tracks walked over are put off, not moved, so that the deck
+        // stays what the seed says it is.
+        uint32_t Pick = Cursor;
+
+        if (Shuffle)
+        {
+            while ( (Pick < Deck.size () ) && RecentlyPlayed (Deck[Pick]) )
+            {
+                ++Pick;
+            }
+
+            if ( (Pick >= Deck.size () ) || ( (Pick - Cursor) > (GATE_PLAYLIST_MAX_NO_REPEAT - DeferredCount) ) )
+            {
+                // nothing else left in this deck, or no room to remember the rest
+                Pick = Cursor;
+            }
+
+            for ( ; Cursor < Pick; ++Cursor)
+            {
+                Deferred[DeferredCount++] = Deck[Cursor];
+                ++RepeatsAvoided;
+            }
+        }
+
+        Track = Deck[Cursor++];
+    } while (false);
+
+    if (Response)
+    {
+        if (NoRepeat)
+        {
+            Recent[RecentIndex] = Track;
+            RecentIndex         = (RecentIndex + 1) % NoRepeat;
+            RecentCount         = min (RecentCount + 1, NoRepeat);
+        }
+
+        StateIsDirty = true;
+    }
+
+    // DEBUG_END;
+    return(Response);
+}  // Next
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::TakeDeferred (uint32_t Index, Track_t & Track)
+{
+    Track = Deferred[Index];
+    --DeferredCount;
+
+    for ( ; Index < DeferredCount; ++Index)
+    {
+        Deferred[Index] = Deferred[Index + 1];
+    }
+}  // TakeDeferred
+
+// -----------------------------------------------------------------------------
+///< 1 for the track played last. RecentCount + 1 if it is not recent
+uint32_t c_GatePlaylist::PlaysSince (const Track_t & Track)
+{
+    uint32_t Response = RecentCount + 1;
+
+    for (uint32_t count = 1; count <= RecentCount; ++count)
+    {
+        if (SameTrack (Recent[(RecentIndex + NoRepeat - count) % NoRepeat], Track) )
+        {
+            Response = count;
+            break;
+        }
+    }
+
+    return(Response);
+}  // PlaysSince
+
+// -----------------------------------------------------------------------------
+bool c_GatePlaylist::RecentlyPlayed (const Track_t & Track)
+{
+    bool Response = false;
+
+    for (uint32_t index = 0; index < RecentCount; ++index)
+    {
+        if (SameTrack (Recent[index], Track) )
+        {
+            Response = true;
+            break;
+        }
+    }
+
+    return(Response);
+}  // RecentlyPlayed
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::BuildDeck ()
+{
+    // DEBUG_START;
+
+    Deck.clear ();
+
+    if (Folders.empty () )
+    {
+        Deck.reserve (NumFilesOnCard);
+
+        for (uint32_t File = 1; File <= NumFilesOnCard; ++File)
+        {
+            Track_t NewTrack = {0, uint16_t (File)};
+            Deck.push_back (NewTrack);
+        }
+    }
+    else
+    {
+        uint32_t DeckSize = 0;
+
+        for (auto & CurrentFolder : Folders)
+        {
+            DeckSize += FilesInFolder (CurrentFolder) * CurrentFolder.Weight;
+        }
+
+        Deck.reserve (DeckSize);
+
+        for (auto & CurrentFolder : Folders)
+        {
+            uint16_t Files = FilesInFolder (CurrentFolder);
+
+            for (uint8_t Copy = 0; Copy < CurrentFolder.Weight; ++Copy)
+            {
+                for (uint16_t File = 1; File <= Files; ++File)
+                {
+                    Track_t NewTrack = {CurrentFolder.Folder, File};
+                    Deck.push_back (NewTrack);
+                }
+            }
+        }
+    }
+
+    // DEBUG_END;
+}  // BuildDeck
+
+// -----------------------------------------------------------------------------
+///< What the card has, limited by the config. The config alone if the card
+///< has not been asked about the folder.
+uint16_t c_GatePlaylist::FilesInFolder (const FolderConfig_t & Folder)
+{
+    uint16_t response = Folder.Files;
+
+    for (auto & CurrentFolder : FolderFilesOnCard)
+    {
+        if (Folder.Folder == CurrentFolder.Folder)
+        {
+            response = (0 == Folder.Files) ? CurrentFolder.Files : min (Folder.Files, CurrentFolder.Files);
+            break;
+        }
+    }
+
+    return(response);
+}  // FilesInFolder
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::ShuffleDeck ()
+{
+    // DEBUG_START;
+
+    // always start from the same order so that a seed describes the deck
+    BuildDeck ();
+    Random.Seed (DeckSeed);
+    Cursor = 0;
+
+    if (Shuffle)
+    {
+        for (uint32_t index = Deck.size (); index > 1; --index)
+        {
+            std::swap ( Deck[index - 1], Deck[Random.Below (index)] );
+        }
+    }
+
+    StateIsDirty = true;
+
+    // DEBUG_END;
+}  // ShuffleDeck
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::LoadState ()
+{
+    // DEBUG_START;
+
+    DynamicJsonDocument StateDoc (GATE_PLAYLIST_STATE_DOC_SIZE);
+
+    do  // once
+    {
+        DeckSeed = esp_random ();
+        RecentCount = 0;
+        RecentIndex = 0;
+        DeferredCount = 0;
+
+        if (!FileMgr.ReadConfigFile (GATE_PLAYLIST_FILE_NAME, StateDoc) )
+        {
+            ShuffleDeck ();
+            break;
+        }
+
+        uint32_t    SavedSize   = 0;
+        bool        SavedShuffle = !Shuffle;
+        uint32_t    SavedCursor = 0;
+        setFromJSON (SavedSize,     StateDoc, F ("size") );
+        setFromJSON (SavedShuffle,  StateDoc, F ("shuffle") );
+        setFromJSON (SavedCursor,   StateDoc, F ("cursor") );
+        setFromJSON (DeckSeed,      StateDoc, F ("seed") );
+
+        ShuffleDeck ();
+
+        // a different card or different rules. Start over
+        if ( (SavedSize != Deck.size () ) || (SavedShuffle != Shuffle) || (SavedCursor > Deck.size () ) )
+        {
+            logcon ( F ("Saved rotation does not match the card. Starting a new one") );
+            DeckSeed = esp_random ();
+            ShuffleDeck ();
+            break;
+        }
+
+        Cursor = SavedCursor;
+
+        JsonArray JsonRecent = StateDoc[F ("recent")];
+
+        for (JsonArray JsonTrack : JsonRecent)
+        {
+            if ( (RecentCount >= NoRepeat) || (2 != JsonTrack.size () ) )
+            {
+                break;
+            }
+
+            Recent[RecentCount].Folder = JsonTrack[0];
+            Recent[RecentCount].File   = JsonTrack[1];
+            ++RecentCount;
+        }
+
+        RecentIndex  = (NoRepeat) ? (RecentCount % NoRepeat) : 0;
+
+        JsonArray JsonDeferred = StateDoc[F ("deferred")];
+
+        for (JsonArray JsonTrack : JsonDeferred)
+        {
+            if ( (DeferredCount >= GATE_PLAYLIST_MAX_NO_REPEAT) || (2 != JsonTrack.size () ) )
+            {
+                break;
+            }
+
+            Deferred[DeferredCount].Folder = JsonTrack[0];
+            Deferred[DeferredCount].File   = JsonTrack[1];
+            ++DeferredCount;
+        }
+
+        StateIsDirty = false;
+
+        logcon ( String ( F ("Resuming rotation at ") ) + String (Cursor) + F (" of ") + String ( Deck.size () ) );
+    } while (false);
+
+    LastSaveMs = millis ();
+
+    // DEBUG_END;
+}  // LoadState
+
+// -----------------------------------------------------------------------------
+void c_GatePlaylist::SaveState ()
+{
+    // DEBUG_START;
+
+    DynamicJsonDocument StateDoc (GATE_PLAYLIST_STATE_DOC_SIZE);
+
+    StateDoc[F ("seed")]    = DeckSeed;
+    StateDoc[F ("cursor")]  = Cursor;
+    StateDoc[F ("size")]    = Deck.size ();
+    StateDoc[F ("shuffle")] = Shuffle;
+
+    // oldest first so that the ring can be refilled in order
+    JsonArray JsonRecent = StateDoc.createNestedArray (F ("recent") );
+
+    for (uint32_t count = 0; count < RecentCount; ++count)
+    {
+        uint32_t    index       = (RecentIndex + NoRepeat - RecentCount + count) % NoRepeat;
+        JsonArray   JsonTrack   = JsonRecent.createNestedArray ();
+        JsonTrack.add (Recent[index].Folder);
+        JsonTrack.add (Recent[index].File);
+    }
+
+    JsonArray JsonDeferred = StateDoc.createNestedArray (F ("deferred") );
+
+    for (uint32_t index = 0; index < DeferredCount; ++index)
+    {
+        JsonArray JsonTrack = JsonDeferred.createNestedArray ();
+        JsonTrack.add (Deferred[index].Folder);
+        JsonTrack.add (Deferred[index].File);
+    }
+
+    FileMgr.SaveConfigFile (GATE_PLAYLIST_FILE_NAME, StateDoc);
+
+    StateIsDirty = false;
+    LastSaveMs   = millis ();
+
+    // DEBUG_END;
+}  // SaveState
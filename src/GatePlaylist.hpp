@@ -0,0 +1,131 @@
+#pragma once
+/*
+ * GatePlaylist.hpp - Shuffled play order for the gate audio
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ *   The tracks are dealt like a deck of cards. The deck is shuffled once
+ *   (Fisher-Yates) and then played from a cursor, so picking a track does
+ *   not depend on the number of files on the card. A track is added to the
+ *   deck once per unit of weight of its folder. The deck is reshuffled when
+ *   it runs out. Nothing played in the last NoRepeat picks is played again
+ *   if anything else is available. A recent track is put off (kept aside
+ *   until it is no longer recent), never moved within the deck.
+ *
+ *   The shuffle is driven by a seed so the deck can be rebuilt after a
+ *   reboot from {seed, cursor}. The recent and put off tracks are saved
+ *   with it.
+ *
+ *   The number of files in a folder comes from the card when it is known.
+ *   A file count in the config (0 = all of them) limits it.
+ *
+ */
+
+#include "JurasicParkGate.h"
+#include "FastRandom.hpp"
+#include <vector>
+
+class c_GatePlaylist{
+public:
+
+c_GatePlaylist ();
+virtual ~c_GatePlaylist ();
+
+    #define GATE_PLAYLIST_FILE_NAME         "/playlist.json"
+    #define GATE_PLAYLIST_MAX_NO_REPEAT     32
+    #define GATE_PLAYLIST_DEFAULT_NO_REPEAT 5
+    #define GATE_PLAYLIST_MAX_WEIGHT        10
+    #define GATE_PLAYLIST_SAVE_INTERVAL_MS  (60 * 1000)
+    #define GATE_PLAYLIST_NO_REPEAT_NAME    "norepeat"
+    #define GATE_PLAYLIST_FOLDERS_NAME      "folders"
+    #define GATE_PLAYLIST_FOLDER_NAME       "folder"
+    #define GATE_PLAYLIST_FILES_NAME        "files"
+    #define GATE_PLAYLIST_WEIGHT_NAME       "weight"
+
+// Folder 0 is the flat numbering of every file on the card (play track).
+// Anything else is a numbered folder on the card (play folder / file).
+struct Track_t
+{
+    uint8_t Folder;
+    uint16_t File;
+};
+
+struct FolderFiles_t
+{
+    uint8_t Folder;
+    uint16_t Files;
+};
+
+void Begin      (uint32_t                       NumFilesOnCard,
+ const std::vector <FolderFiles_t> &            FolderFilesOnCard);  ///< (re)build the deck. Resumes the saved rotation if it still fits
+void Poll       ();                                 ///< saves the rotation now and then
+void GetConfig  (JsonObject & json);
+bool SetConfig  (JsonObject & json);
+void GetStatus  (JsonObject & json);
+
+bool Next       (Track_t & Track);                  ///< false if there is nothing to play
+void SetShuffle (bool Shuffle);
+void GetFolders (std::vector <uint8_t> & List)     {List.clear (); for (auto & CurrentFolder : Folders) {List.push_back (CurrentFolder.Folder);}}
+
+void GetDriverName (String & Name) {Name = "Playlist";}
+
+private:
+
+struct FolderConfig_t
+{
+    uint8_t Folder;
+    uint16_t Files;
+    uint8_t Weight;
+};
+
+void BuildDeck ();
+uint16_t FilesInFolder (const FolderConfig_t & Folder);
+void ShuffleDeck ();
+bool RecentlyPlayed (const Track_t & Track);
+void TakeDeferred (uint32_t Index,
+ Track_t &                   Track);
+uint32_t PlaysSince (const Track_t & Track);
+void LoadState ();
+void SaveState ();
+
+static bool SameTrack (const Track_t & a, const Track_t & b) {return( (a.Folder == b.Folder) && (a.File == b.File) );}
+
+// config
+bool Shuffle                = true;
+uint32_t NoRepeat           = GATE_PLAYLIST_DEFAULT_NO_REPEAT;
+std::vector <FolderConfig_t> Folders;               // empty = every file on the card, weight 1
+uint32_t NumFilesOnCard     = 0;
+std::vector <FolderFiles_t> FolderFilesOnCard;      // folders the card has been asked about
+
+// rotation
+std::vector <Track_t> Deck;
+uint32_t Cursor             = 0;
+uint32_t DeckSeed           = 0;                    // seed of the current shuffle
+c_FastRandom Random;
+Track_t Recent[GATE_PLAYLIST_MAX_NO_REPEAT];
+uint32_t RecentCount        = 0;
+uint32_t RecentIndex        = 0;
+Track_t Deferred[GATE_PLAYLIST_MAX_NO_REPEAT];     // passed over by the cursor while recent. Oldest first
+uint32_t DeferredCount      = 0;
+
+// persistence
+bool StateIsDirty           = false;
+uint32_t LastSaveMs         = 0;
+
+// statistics
+uint32_t Reshuffles         = 0;
+uint32_t RepeatsAvoided     = 0;
+
+}; // c_GatePlaylist
@@ -178,14 +178,25 @@ void c_GateDoors::SetChannelData(uint8_t value)
 
     // _ DEBUG_V(String("value: ") + String(value));
 
-    uint8_t buffer = value;
+    // a zero length move also cancels any move in progress
+    MoveDoors(value, 0);
+
+    // _ DEBUG_END;
+} // SetChannelData
+
+// -----------------------------------------------------------------------------
+void c_GateDoors::MoveDoors(uint8_t TargetPosition, uint32_t DurationMS)
+{
+    // DEBUG_START;
+
+    // the output driver ramps the doors. We only send the end point.
     for(auto CurrentChannel : doorChannels)
     {
-        OutputMgr.WriteChannelData(CurrentChannel, 1, &buffer);
+        OutputMgr.MoveChannelTo(CurrentChannel, TargetPosition, DurationMS);
     }
 
-    // _ DEBUG_END;
-} // SetChannelData
+    // DEBUG_END;
+} // MoveDoors
 
 // -----------------------------------------------------------------------------
 bool c_GateDoors::IsOpen()
@@ -266,7 +277,8 @@ void FsmDoorStateOpening::init(c_GateDoors* pParent)
 
     // Determine time needed to move door from current postion to full open
     uint32_t TimeRemainingMS = map(pParent->CurrentPosition, CLOSED_VALUE, FULL_OPEN_VALUE, pParent->TimeToOpenMS, 0);
-    pParent->TimeStartedMS = millis() - (TimeRemainingMS - pParent->TimeToOpenMS);
+    pParent->TimeStartedMS = millis() - (pParent->TimeToOpenMS - TimeRemainingMS);
+    pParent->MoveDoors(FULL_OPEN_VALUE, TimeRemainingMS);
     // DEBUG_V(String("            now: ") + String(millis()));
     // DEBUG_V(String("  TimeStartedMS: ") + String(pParent->TimeStartedMS));
     // DEBUG_V(String("TimeRemainingMS: ") + String(TimeRemainingMS));
@@ -279,7 +291,7 @@ void FsmDoorStateOpening::poll(c_GateDoors* pParent)
 {
     // _ DEBUG_START;
 
-    // Update the current door position
+    // Track the door position. The output driver is doing the actual move.
     pParent->TimeElapsedMS = min( (uint32_t( millis() ) - pParent->TimeStartedMS), pParent->TimeToOpenMS );
     pParent->CurrentPosition = map(pParent->TimeElapsedMS, 0, pParent->TimeToOpenMS, CLOSED_VALUE, FULL_OPEN_VALUE);
 
@@ -293,10 +305,6 @@ void FsmDoorStateOpening::poll(c_GateDoors* pParent)
     {
         FsmDoorStateOpen_Imp.init(pParent);
     }
-    else
-    {
-        pParent->SetChannelData(pParent->CurrentPosition);
-    }
 
     // _ DEBUG_END;
 } // FsmDoorStateOpening::poll
@@ -368,6 +376,7 @@ void FsmDoorStateClosing::init(c_GateDoors* pParent)
     // Determine time needed to move door from current postion to full closed
     uint32_t TimeRemainingMS = map(long(pParent->CurrentPosition), CLOSED_VALUE, FULL_OPEN_VALUE, 0, pParent->TimeToCloseMS);
     pParent->TimeStartedMS = millis() + (TimeRemainingMS - pParent->TimeToCloseMS);
+    pParent->MoveDoors(CLOSED_VALUE, TimeRemainingMS);
     // DEBUG_V(String("CurrentPosition: ") + String(pParent->CurrentPosition));
     // DEBUG_V(String("            now: ") + String(millis()));
     // DEBUG_V(String("  TimeStartedMS: ") + String(pParent->TimeStartedMS));
@@ -381,7 +390,7 @@ void FsmDoorStateClosing::poll(c_GateDoors* pParent)
 {
     // _ DEBUG_START;
 
-    // output current door position
+    // Track the door position. The output driver is doing the actual move.
     pParent->TimeElapsedMS = min( (uint32_t( millis() ) - pParent->TimeStartedMS), pParent->TimeToCloseMS );
     pParent-> CurrentPosition = map(pParent->TimeElapsedMS, 0, pParent->TimeToCloseMS, FULL_OPEN_VALUE, CLOSED_VALUE);
 
@@ -395,10 +404,6 @@ void FsmDoorStateClosing::poll(c_GateDoors* pParent)
     {
         FsmDoorStateClosed_Imp.init(pParent);
     }
-    else
-    {
-        pParent->SetChannelData(pParent->CurrentPosition);
-    }
 
     // _ DEBUG_END;
 } // FsmDoorStateClosing::poll
@@ -25,6 +25,7 @@ class c_GateDoors{
 protected:
 
 void SetChannelData(uint8_t);
+void MoveDoors(uint8_t TargetPosition, uint32_t DurationMS);
 
 uint8_t doorChannels[2] = {15, 31};
 uint32_t TimeToOpenMS = 45000;
@@ -44,7 +44,9 @@ void c_GateLights::Begin ()
     // DEBUG_START;
 
     do  // once
-    {} while (false);
+    {
+        Random.Seed ( (0 == Seed) ? esp_random () : Seed );
+    } while (false);
 
     // DEBUG_END;
 }  // begin
@@ -56,6 +58,29 @@ bool c_GateLights::SetConfig (JsonObject & json)
 
     bool ConfigChanged = false;
 
+    do // once
+    {
+        if( !json.containsKey(CN_lights) )
+        {
+            logcon( F("No Lights configuration. Using defaults") );
+            break;
+        }
+        JsonObject  jsonLights = json[CN_lights];
+
+        float Brightness = EffectBrightness * 100.0;
+        ConfigChanged |= setFromJSON(Brightness,  jsonLights, CN_brightness);
+        ConfigChanged |= setFromJSON(EffectGamma, jsonLights, CN_gamma);
+
+        if( setFromJSON(Seed, jsonLights, "Seed") )
+        {
+            ConfigChanged = true;
+            Random.Seed ( (0 == Seed) ? esp_random () : Seed );
+        }
+
+        setBrightness(Brightness / 100.0);
+
+    } while(false);
+
     // DEBUG_END;
 
     return(ConfigChanged);
@@ -66,7 +91,11 @@ void c_GateLights::GetConfig (JsonObject & json)
 {
     // DEBUG_START;
 
-    // json[CN_miso_pin]  = miso_pin;
+    JsonObject jsonLights = json.createNestedObject(CN_lights);
+
+    jsonLights[CN_brightness] = uint32_t(EffectBrightness * 100.0);
+    jsonLights[CN_gamma]      = EffectGamma;
+    jsonLights["Seed"]        = Seed;
 
     // DEBUG_END;
 }  // GetConfig
@@ -124,9 +153,9 @@ void c_GateLights::Poll ()
 
         for (uint16_t i = 0; i < PixelCount; i++)
         {
-            uint8_t red = random (120) + 135;
-            uint8_t grn = random (red/2);
-            uint8_t blu = random (grn/2);
+            uint8_t red = Random.Below (120) + 135;
+            uint8_t grn = Random.Below (red/2);
+            uint8_t blu = Random.Below (grn/2);
             setPixel (
                 i,
                 CRGB{
@@ -138,13 +167,26 @@ void c_GateLights::Poll ()
 
         EffectWait = EffectDelay/ 10;
 
-        EffectDelayTimer.StartTimer (random(EffectWait)+75);
+        EffectDelayTimer.StartTimer (Random.Below(EffectWait)+75);
 
     } while(false);
 
     // _ DEBUG_END;
 }  // Poll
 
+// -----------------------------------------------------------------------------
+void c_GateLights::setBrightness (float brightness)
+{
+    // DEBUG_START;
+
+    EffectBrightness = constrain (brightness, 0.0F, 1.0F);
+    EffectGamma      = constrain (EffectGamma, float(BRIGHTNESS_LUT_MIN_GAMMA), float(BRIGHTNESS_LUT_MAX_GAMMA));
+
+    BrightnessLut.Build (EffectBrightness, EffectGamma);
+
+    // DEBUG_END;
+} // setBrightness
+
 // -----------------------------------------------------------------------------
 void c_GateLights::clearAll ()
 {
@@ -189,9 +231,9 @@ void c_GateLights::setPixel (uint16_t pixelId, CRGB color)
         // DEBUG_V (String ("color.g: ") + String (color.g));
         // DEBUG_V (String ("color.b: ") + String (color.b));
 
-        PixelBuffer[0] = color.r * EffectBrightness;
-        PixelBuffer[1] = color.g * EffectBrightness;
-        PixelBuffer[2] = color.b * EffectBrightness;
+        PixelBuffer[0] = BrightnessLut[color.r];
+        PixelBuffer[1] = BrightnessLut[color.g];
+        PixelBuffer[2] = BrightnessLut[color.b];
 
         OutputMgr.WriteChannelData (StartChannel, 3, PixelBuffer);
     }
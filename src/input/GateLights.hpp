@@ -19,6 +19,8 @@
  */
 
 #include "JurasicParkGate.h"
+#include "BrightnessLut.hpp"
+#include "FastRandom.hpp"
 
 class c_GateLights{
 private:
@@ -120,7 +122,11 @@ uint16_t EffectDelay        = 1000;
 uint32_t EffectWait = 32;                                   /* How long to wait for the effect to run again */
 FastTimer EffectDelayTimer;
 bool Enabled = false;
-uint32_t EffectBrightness = 1;
+float EffectBrightness = 1.0;                               /* Brightness [0, 1.0] */
+float EffectGamma      = BRIGHTNESS_LUT_DEFAULT_GAMMA;      /* Gamma curve [1.0, 3.0] */
+c_BrightnessLut BrightnessLut;
+uint32_t Seed          = 0;                                 /* Random number seed. 0 = different every boot */
+c_FastRandom Random;
 
 }; // c_GateLights
 
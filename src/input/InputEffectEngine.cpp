@@ -26,26 +26,39 @@
 // -----------------------------------------------------------------------------
 
 // List of all the supported effects and their names
-static const c_InputEffectEngine::EffectDescriptor_t ListOfEffects[] =
+#define EFFECT_HASH(name) name, c_InputEffectEngine::EffectNameHash (name)
+static constexpr c_InputEffectEngine::EffectDescriptor_t ListOfEffects[] =
 {
-    //                                                                              Mirror      AllLeds      wsTCode
-    //    name                              func                   htmlid               Color      Reverse
-
-    // { "Disabled",     nullptr,                             "t_disabled",     1, 1, 1, 1, "T0"  },
-    {"Solid",        &c_InputEffectEngine::effectSolidColor,  "t_static",      1, 0, 0, 0, "T1"  },
-    {"Blink",        &c_InputEffectEngine::effectBlink,       "t_blink",       1, 0, 0, 0, "T2"  },
-    {"Flash",        &c_InputEffectEngine::effectFlash,       "t_flash",       1, 0, 0, 0, "T3"  },
-    {"Rainbow",      &c_InputEffectEngine::effectRainbow,     "t_rainbow",     0, 1, 1, 1, "T5"  },
-    {"Chase",        &c_InputEffectEngine::effectChase,       "t_chase",       1, 1, 1, 0, "T4"  },
-    {"Fire flicker", &c_InputEffectEngine::effectFireFlicker, "t_fireflicker", 1, 0, 0, 0, "T6"  },
-    {"Lightning",    &c_InputEffectEngine::effectLightning,   "t_lightning",   1, 0, 0, 0, "T7"  },
-    {"Breathe",      &c_InputEffectEngine::effectBreathe,     "t_breathe",     1, 0, 0, 0, "T8"  },
-    {"Random",       &c_InputEffectEngine::effectRandom,      "t_random",      0, 0, 0, 0, "T9"  },
-    {"Transition",   &c_InputEffectEngine::effectTransition,  "t_Transition",  0, 0, 0, 0, "T10" },
-    {"Marquee",      &c_InputEffectEngine::effectMarquee,     "t_Marquee",     0, 0, 0, 0, "T11" }
+    //                                                                                            Mirror   AllLeds      wsTCode
+    //    name                        func                                     htmlid         Color   Reverse   White
+
+    // { EFFECT_HASH ("Disabled"),     nullptr,                                  "t_disabled",     1, 1, 1, 1, 0, "T0"  },
+    {EFFECT_HASH ("Solid"),          &c_InputEffectEngine::effectSolidColor,  "t_static",      1, 0, 0, 0, 0, "T1"  },
+    {EFFECT_HASH ("Blink"),          &c_InputEffectEngine::effectBlink,       "t_blink",       1, 0, 0, 0, 0, "T2"  },
+    {EFFECT_HASH ("Flash"),          &c_InputEffectEngine::effectFlash,       "t_flash",       1, 0, 0, 0, 0, "T3"  },
+    {EFFECT_HASH ("Rainbow"),        &c_InputEffectEngine::effectRainbow,     "t_rainbow",     0, 1, 1, 1, 0, "T5"  },
+    {EFFECT_HASH ("Chase"),          &c_InputEffectEngine::effectChase,       "t_chase",       1, 1, 1, 0, 0, "T4"  },
+    {EFFECT_HASH ("Fire flicker"),   &c_InputEffectEngine::effectFireFlicker, "t_fireflicker", 1, 0, 0, 0, 0, "T6"  },
+    {EFFECT_HASH ("Lightning"),      &c_InputEffectEngine::effectLightning,   "t_lightning",   1, 0, 0, 0, 0, "T7"  },
+    {EFFECT_HASH ("Breathe"),        &c_InputEffectEngine::effectBreathe,     "t_breathe",     1, 0, 0, 0, 0, "T8"  },
+    {EFFECT_HASH ("Random"),         &c_InputEffectEngine::effectRandom,      "t_random",      0, 0, 0, 0, 0, "T9"  },
+    {EFFECT_HASH ("Transition"),     &c_InputEffectEngine::effectTransition,  "t_Transition",  0, 0, 0, 0, 0, "T10" },
+    {EFFECT_HASH ("Marquee"),        &c_InputEffectEngine::effectMarquee,     "t_Marquee",     0, 0, 0, 0, 0, "T11" }
 };
 
-static std::vector <c_InputEffectEngine::dCRGB> TransitionColorTable =
+#define NUM_EFFECTS ( sizeof (ListOfEffects) / sizeof (ListOfEffects[0]) )
+
+// Names used in the config for the blend modes (indexed by BlendMode_t)
+static const char * BlendModeNames[] =
+{
+    "replace",
+    "add",
+    "max",
+    "multiply",
+    "alpha",
+};
+
+static std::vector <c_InputEffectEngine::CRGB> TransitionColorTable =
 {
     { 85, 85,  85 },
     {128, 128, 0  },
@@ -99,6 +112,7 @@ c_InputEffectEngine::c_InputEffectEngine (c_InputMgr::e_InputChannelIds NewInput
 
     SetBufferInfo (BufferSize);
 
+    EffectRenderStats.resize (NUM_EFFECTS);
     TransitionTargetColorIterator = TransitionColorTable.begin ();
 
     // DEBUG_END;
@@ -115,6 +129,7 @@ c_InputEffectEngine::c_InputEffectEngine () :
 
     SetBufferInfo (0);
 
+    EffectRenderStats.resize (NUM_EFFECTS);
     TransitionTargetColorIterator = TransitionColorTable.begin ();
 
     // DEBUG_END;
@@ -136,6 +151,7 @@ void c_InputEffectEngine::Begin ()
 
     HasBeenInitialized = true;
 
+    SeedRandom ();
     validateConfiguration ();
     // DEBUG_V ("");
 
@@ -157,10 +173,14 @@ void c_InputEffectEngine::GetConfig (JsonObject & jsonConfig)
     jsonConfig[CN_EffectMirror]       = EffectMirror;
     jsonConfig[CN_EffectAllLeds]      = EffectAllLeds;
     jsonConfig[CN_EffectBrightness]   = uint32_t (EffectBrightness * 100.0);
+    jsonConfig[CN_gamma]              = EffectGamma;
     jsonConfig[CN_EffectWhiteChannel] = EffectWhiteChannel;
     jsonConfig[CN_EffectColor]        = HexColor;
     jsonConfig[CN_pixel_count]        = effectMarqueePixelAdvanceCount;
 
+    jsonConfig["TimeBased"]     = EffectTimeBased;
+    jsonConfig["Seed"]          = EffectSeed;
+
     jsonConfig["FlashEnable"]   = FlashInfo.Enable;
     jsonConfig["FlashMinInt"]   = FlashInfo.MinIntensity;
     jsonConfig["FlashMaxInt"]   = FlashInfo.MaxIntensity;
@@ -168,13 +188,15 @@ void c_InputEffectEngine::GetConfig (JsonObject & jsonConfig)
     jsonConfig["FlashMaxDelay"] = FlashInfo.MaxDelayMS;
     jsonConfig["FlashMinDur"]   = FlashInfo.MinDurationMS;
     jsonConfig["FlashMaxDur"]   = FlashInfo.MaxDurationMS;
+    jsonConfig["FlashBlend"]    = BlendModeNames[Layers[LayerFlash].Mode];
+    jsonConfig["MasterDimmer"]  = MasterDimmer;
 
     // DEBUG_V ("");
 
     JsonArray EffectsArray = jsonConfig.createNestedArray (CN_effects);
     // DEBUG_V ("");
 
-    for (EffectDescriptor_t currentEffect : ListOfEffects)
+    for (const EffectDescriptor_t & currentEffect : ListOfEffects)
     {
         // DEBUG_V ("");
         JsonObject currentJsonEntry = EffectsArray.createNestedObject ();
@@ -213,7 +235,7 @@ void c_InputEffectEngine::GetMqttEffectList (JsonObject & jsonConfig)
     // DEBUG_START;
     JsonArray EffectsArray = jsonConfig.createNestedArray (CN_effect_list);
 
-    for (EffectDescriptor_t currentEffect : ListOfEffects)
+    for (const EffectDescriptor_t & currentEffect : ListOfEffects)
     {
         EffectsArray.add (currentEffect.name);
     }
@@ -247,40 +269,55 @@ void c_InputEffectEngine::GetStatus (JsonObject & jsonStatus)
     JsonObject Status = jsonStatus.createNestedObject ( F ("effects") );
     Status[CN_currenteffect] = ActiveEffect->name;
     Status[CN_id]            = InputChannelId;
+    Status["TimeBased"]      = EffectTimeBased;
+    Status["FrameDeadlineMisses"] = FrameDeadlineMisses;
+
+    // how long each effect takes to render a frame
+    JsonArray RenderStatsArray = Status.createNestedArray ( F ("render") );
+    for (uint32_t EffectIndex = 0; EffectIndex < NUM_EFFECTS; ++EffectIndex)
+    {
+        if (0 != EffectRenderStats[EffectIndex].Frames)
+        {
+            JsonObject EffectStats = RenderStatsArray.createNestedObject ();
+            EffectStats[CN_name] = ListOfEffects[EffectIndex].name;
+            GetRenderStats (EffectStats, EffectRenderStats[EffectIndex]);
+        }
+    }
+
+    JsonObject OutputStats = Status.createNestedObject ( F ("output") );
+    GetRenderStats (OutputStats, OutputFrameStats);
 
     // DEBUG_END;
 }  // GetStatus
 
 // -----------------------------------------------------------------------------
-void c_InputEffectEngine::NextEffect ()
+void c_InputEffectEngine::GetRenderStats (JsonObject & jsonStats, const RenderStats_t & Stats)
 {
     // DEBUG_START;
 
-    // DEBUG_V ("Find the current effect");
-    uint32_t CurrentEffectIndex = 0;
-    for (const EffectDescriptor_t currentEffect : ListOfEffects)
-    {
-        // DEBUG_V (String ("currentEffect.name: ") + currentEffect.name);
-        if (ActiveEffect->name == currentEffect.name)
-        {
-            // DEBUG_V (String ("currentEffect.name: ") + currentEffect.name);
-            break;
-        }
+    jsonStats["FrameCount"] = Stats.Frames;
+    jsonStats["MinUs"]      = (0 == Stats.Frames) ? 0 : Stats.MinUs;
+    jsonStats["AvgUs"]      = (0 == Stats.Frames) ? 0 : uint32_t (Stats.TotalUs / Stats.Frames);
+    jsonStats["MaxUs"]      = Stats.MaxUs;
 
-        ++CurrentEffectIndex;
-    }
+    // DEBUG_END;
+}  // GetRenderStats
 
-    // we now have the index of the current effect
-    ++CurrentEffectIndex;
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::NextEffect ()
+{
+    // DEBUG_START;
 
-    if (sizeof (ListOfEffects) / sizeof (ListOfEffects[0]) <= CurrentEffectIndex)
+    uint32_t NextEffectIndex = ActiveEffectIndex + 1;
+
+    if (NUM_EFFECTS <= NextEffectIndex)
     {
         // DEBUG_V ("Wrap to first effect");
-        CurrentEffectIndex = 0;
+        NextEffectIndex = 0;
     }
 
-    // DEBUG_V (String ("CurrentEffectIndex: ") + String(CurrentEffectIndex));
-    setEffect (ListOfEffects[CurrentEffectIndex].name);
+    // DEBUG_V (String ("NextEffectIndex: ") + String(NextEffectIndex));
+    setEffect (NextEffectIndex);
     logcon (String ( F ("Setting new effect: ") ) + ActiveEffect->name);
     // DEBUG_V (String ("ActiveEffect->name: ") + ActiveEffect->name);
 
@@ -288,13 +325,19 @@ void c_InputEffectEngine::NextEffect ()
 }  // NextEffect
 
 // -----------------------------------------------------------------------------
-void c_InputEffectEngine::PollFlash ()
+bool c_InputEffectEngine::PollFlash ()
 {
+    // returns true if the flash layer changed and the frame needs to be output
+    bool            Response   = false;
+    EffectLayer_t & FlashLayer = Layers[LayerFlash];
+
     do  // once
     {
         if (!FlashInfo.Enable)
         {
             // not doing random flashing
+            Response           = FlashLayer.Enabled;
+            FlashLayer.Enabled = false;
             break;
         }
 
@@ -308,28 +351,28 @@ void c_InputEffectEngine::PollFlash ()
         if ( FlashInfo.durationtimer.IsExpired () )
         {
             // set up the next flash
-            uint32_t    NextDelay    = random (FlashInfo.MinDelayMS, FlashInfo.MaxDelayMS);
-            uint32_t    NextDuration = random (FlashInfo.MinDurationMS, FlashInfo.MaxDurationMS);
+            uint32_t    NextDelay    = Random.Range (FlashInfo.MinDelayMS, FlashInfo.MaxDelayMS);
+            uint32_t    NextDuration = Random.Range (FlashInfo.MinDurationMS, FlashInfo.MaxDurationMS);
 
             FlashInfo.delaytimer.StartTimer (NextDelay);
             FlashInfo.durationtimer.StartTimer (NextDelay + NextDuration);
-
-            // force the effect to overwrite the buffer
-            EffectDelayTimer.CancelTimer ();
             // DEBUG_V(String("   NextDelay: ") + String(NextDelay));
             // DEBUG_V(String("NextDuration: ") + String(NextDuration));
 
-            // dont overwrite the buffer
+            // remove the flash. The effect frame underneath is still intact.
+            Response           = FlashLayer.Enabled;
+            FlashLayer.Enabled = false;
             break;
         }
 
-        uint8_t intensity = uint8_t ( map (random (FlashInfo.MinIntensity, FlashInfo.MaxIntensity), 0, 100, 0, 255) );
-        CRGB    color;
-        color.r = intensity;
-        color.g = intensity;
-        color.b = intensity;
-        setAll (color);
+        uint8_t intensity = uint8_t ( map (Random.Range (FlashInfo.MinIntensity, FlashInfo.MaxIntensity), 0, 100, 0, 255) );
+        FlashLayer.Color   = PackColor ({intensity, intensity, intensity});
+        FlashLayer.Alpha   = intensity;
+        FlashLayer.Enabled = true;
+        Response           = true;
     } while (false);
+
+    return(Response);
 }  // PollFlash
 
 // -----------------------------------------------------------------------------
@@ -356,25 +399,95 @@ void c_InputEffectEngine::Process ()
 
         // DEBUG_V ("Pixel Count OK");
 
-        if ( !EffectDelayTimer.IsExpired () )
+        bool FrameHasChanged = false;
+
+        UpdateEffectClock ();
+
+        if (EffectClockUs >= NextFrameDueUs)
         {
-            PollFlash ();
-            break;
+            // DEBUG_V ("Render the next frame");
+
+            // How many whole frame periods have gone by since this frame was due
+            uint64_t    FramePeriodUs = uint64_t (EffectWait) * 1000;
+            uint64_t    MaxMissed     = max ( uint64_t (1), uint64_t (EFFECT_CLOCK_MAX_GAP_US) / FramePeriodUs );
+            uint32_t    MissedFrames  = uint32_t ( min ( MaxMissed, (EffectClockUs - NextFrameDueUs) / FramePeriodUs ) );
+
+            // the first frame after a pause is not late
+            if (EffectClockResynced)
+            {
+                EffectClockResynced = false;
+                MissedFrames        = 0;
+            }
+
+            FrameDeadlineMisses += MissedFrames;
+
+            // In time based mode the late frames are dropped and the effect
+            // catches up by the number of steps that should have been shown.
+            EffectStepsDue  = (EffectTimeBased) ? (1 + MissedFrames) : 1;
+            EffectElapsedUs = EffectClockUs - EffectStartUs;
+
+            FrameIsMapped = false;
+            uint32_t RenderStartUs = micros ();
+            uint32_t wait = (this->*ActiveEffect->func)();
+            EffectRenderStats[ActiveEffectIndex].Add (micros () - RenderStartUs);
+            EffectWait = max ( (int)wait, MIN_EFFECT_DELAY );
+
+            if (EffectTimeBased && (EffectClockUs < (NextFrameDueUs + EFFECT_CLOCK_MAX_GAP_US) ) )
+            {
+                // keep the effect on its own time line
+                NextFrameDueUs += (uint64_t (MissedFrames) * FramePeriodUs) + ( uint64_t (EffectWait) * 1000 );
+            }
+            else
+            {
+                NextFrameDueUs = EffectClockUs + ( uint64_t (EffectWait) * 1000 );
+            }
+
+            EffectCounter++;
+            InputMgr.RestartBlankTimer ( GetInputChannelId () );
+            FrameHasChanged = true;
         }
 
-        // DEBUG_V ("Update output");
-        uint32_t wait = (this->*ActiveEffect->func)();
-        EffectWait = max ( (int)wait, MIN_EFFECT_DELAY );
-        EffectDelayTimer.StartTimer (EffectWait);
-        EffectCounter++;
-        InputMgr.RestartBlankTimer ( GetInputChannelId () );
+        if ( PollFlash () )
+        {
+            FrameHasChanged = true;
+        }
 
-        PollFlash ();
+        if (FrameHasChanged)
+        {
+            // DEBUG_V ("Update output");
+            uint32_t OutputStartUs = micros ();
+            OutputFrame ();
+            OutputFrameStats.Add (micros () - OutputStartUs);
+        }
     } while (false);
 
     // DEBUG_END;
 }  // process
 
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::UpdateEffectClock ()
+{
+    // DEBUG_START;
+
+    // micros() wraps every 71 minutes. The unsigned delta does not care.
+    uint32_t    Now     = micros ();
+    uint32_t    DeltaUs = Now - EffectClockLastMicros;
+    EffectClockLastMicros = Now;
+
+    // MQTT and Alexa stop calling Process while their channel is off. Do not
+    // let the effect see that time. It picks up where it was paused.
+    if (DeltaUs > EFFECT_CLOCK_MAX_GAP_US)
+    {
+        DeltaUs             = 0;
+        NextFrameDueUs      = min (NextFrameDueUs, EffectClockUs);
+        EffectClockResynced = true;
+    }
+
+    EffectClockUs += DeltaUs;
+
+    // DEBUG_END;
+}  // UpdateEffectClock
+
 // -----------------------------------------------------------------------------
 void c_InputEffectEngine::SetBufferInfo (uint32_t BufferSize)
 {
@@ -395,6 +508,13 @@ void c_InputEffectEngine::SetBufferInfo (uint32_t BufferSize)
         MirroredPixelCount = (PixelCount / 2) + PixelOffset;
     }
 
+    FrameBuffer.assign (PixelCount, 0);
+    FrameOutputBuffer.assign (PixelCount * ChannelsPerPixel, 0);
+    RandomPixelStates.assign (PixelCount, {0, 0, 0});
+
+    // every config change passes through here
+    MarqueeRingIsDirty = true;
+
     // DEBUG_END;
 }  // SetBufferInfo
 
@@ -410,12 +530,20 @@ bool c_InputEffectEngine::SetConfig (ArduinoJson::JsonObject & jsonConfig)
     setFromJSON (   EffectMirror,                   jsonConfig, CN_EffectMirror);
     setFromJSON (   EffectAllLeds,                  jsonConfig, CN_EffectAllLeds);
     setFromJSON (   EffectBrightness,               jsonConfig, CN_EffectBrightness);
+    setFromJSON (   EffectGamma,                    jsonConfig, CN_gamma);
     setFromJSON (   EffectWhiteChannel,             jsonConfig, CN_EffectWhiteChannel);
     setFromJSON (   effectName,                     jsonConfig, CN_currenteffect);
     setFromJSON (   effectColor,                    jsonConfig, CN_EffectColor);
     // DEBUG_V (String ("effectColor: ") + effectColor);
     setFromJSON (   effectMarqueePixelAdvanceCount, jsonConfig, CN_pixel_count);
 
+    setFromJSON (   EffectTimeBased,                jsonConfig, "TimeBased");
+
+    if ( setFromJSON (EffectSeed, jsonConfig, "Seed") )
+    {
+        SeedRandom ();
+    }
+
     setFromJSON (   FlashInfo.Enable,               jsonConfig, "FlashEnable");
     setFromJSON (   FlashInfo.MinIntensity,         jsonConfig, "FlashMinInt");
     setFromJSON (   FlashInfo.MaxIntensity,         jsonConfig, "FlashMaxInt");
@@ -423,6 +551,19 @@ bool c_InputEffectEngine::SetConfig (ArduinoJson::JsonObject & jsonConfig)
     setFromJSON (   FlashInfo.MaxDelayMS,           jsonConfig, "FlashMaxDelay");
     setFromJSON (   FlashInfo.MinDurationMS,        jsonConfig, "FlashMinDur");
     setFromJSON (   FlashInfo.MaxDurationMS,        jsonConfig, "FlashMaxDur");
+    setFromJSON (   MasterDimmer,                   jsonConfig, "MasterDimmer");
+
+    String FlashBlend = BlendModeNames[Layers[LayerFlash].Mode];
+    setFromJSON (   FlashBlend,                     jsonConfig, "FlashBlend");
+
+    for (uint32_t BlendModeId = 0; BlendModeId < BlendModeCount; ++BlendModeId)
+    {
+        if ( FlashBlend.equalsIgnoreCase (BlendModeNames[BlendModeId]) )
+        {
+            Layers[LayerFlash].Mode = BlendMode_t (BlendModeId);
+            break;
+        }
+    }
 
     // make sure max is really max
     if (FlashInfo.MinIntensity >= FlashInfo.MaxIntensity)
@@ -438,7 +579,7 @@ bool c_InputEffectEngine::SetConfig (ArduinoJson::JsonObject & jsonConfig)
         for (auto currentTransition : TransitionsArray)
         {
             // DEBUG_V ("");
-            dCRGB NewColorTarget;
+            CRGB NewColorTarget = {0, 0, 0};
             setFromJSON (   NewColorTarget.r,   currentTransition,  "r");
             setFromJSON (   NewColorTarget.g,   currentTransition,  "g");
             setFromJSON (   NewColorTarget.b,   currentTransition,  "b");
@@ -526,13 +667,32 @@ void c_InputEffectEngine::validateConfiguration ()
 {
     // DEBUG_START;
 
+    EffectGamma = constrain (EffectGamma, float(BRIGHTNESS_LUT_MIN_GAMMA), float(BRIGHTNESS_LUT_MAX_GAMMA));
     setBrightness (EffectBrightness);
     setSpeed (EffectSpeed);
     setDelay (EffectDelay);
 
+    // the master dimmer is a multiply layer on top of everything else
+    MasterDimmer = min (MasterDimmer, uint32_t (100));
+    uint8_t DimmerLevel = uint8_t ( map (MasterDimmer, 0, 100, 0, 255) );
+    Layers[LayerMasterDimmer].Enabled = (100 != MasterDimmer);
+    Layers[LayerMasterDimmer].Mode    = BlendMultiply;
+    Layers[LayerMasterDimmer].Color   = PackColor ({DimmerLevel, DimmerLevel, DimmerLevel});
+
     // DEBUG_END;
 }  // validateConfiguration
 
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::SeedRandom ()
+{
+    // DEBUG_START;
+
+    // a fixed seed makes the effects repeat exactly from this point on
+    Random.Seed ( (0 == EffectSeed) ? esp_random () : EffectSeed );
+
+    // DEBUG_END;
+}  // SeedRandom
+
 // -----------------------------------------------------------------------------
 void c_InputEffectEngine::setBrightness (float brightness)
 {
@@ -544,6 +704,8 @@ void c_InputEffectEngine::setBrightness (float brightness)
 
     if (EffectBrightness < 0.0) {EffectBrightness = 0.0;}
 
+    BrightnessLut.Build (EffectBrightness, EffectGamma);
+
     // DEBUG_END;
 } // c_InputEffectEngine::setBrightness
 
@@ -571,31 +733,56 @@ void c_InputEffectEngine::setDelay (uint16_t delay)
 }  // setDelay
 
 // -----------------------------------------------------------------------------
-void c_InputEffectEngine::setEffect (const String & effectName)
+uint32_t c_InputEffectEngine::FindEffect (const char * effectName)
 {
     // DEBUG_START;
 
-    int EffectIndex = 0;
-    for (EffectDescriptor_t currentEffect : ListOfEffects)
+    // returns NUM_EFFECTS if the name is not known
+    uint32_t    Response = NUM_EFFECTS;
+    uint32_t    NameHash = EffectNameHash (effectName);
+
+    for (uint32_t EffectIndex = 0; EffectIndex < NUM_EFFECTS; ++EffectIndex)
     {
-        if ( effectName.equalsIgnoreCase (currentEffect.name) )
+        // the hash rejects the mismatches, the string compare guards against collisions
+        if ( (NameHash == ListOfEffects[EffectIndex].nameHash) &&
+             (0 == strcasecmp (effectName, ListOfEffects[EffectIndex].name) ) )
         {
-            // DEBUG_V ("Found desired effect");
-            if ( !ActiveEffect->name.equalsIgnoreCase (currentEffect.name) )
-            {
-                // DEBUG_V ("Starting Effect");
-                ActiveEffect = &ListOfEffects[EffectIndex];
-                EffectDelayTimer.StartTimer (EffectDelay);
-                EffectWait    = MIN_EFFECT_DELAY;
-                EffectCounter = 0;
-                EffectStep    = 0;
-            }
-
+            Response = EffectIndex;
             break;
         }
+    }
+
+    // DEBUG_END;
+    return(Response);
+}  // FindEffect
+
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::setEffect (const String & effectName)
+{
+    // DEBUG_START;
 
-        EffectIndex++;
-    }  // end for each effect
+    setEffect ( FindEffect ( effectName.c_str () ) );
+
+    // DEBUG_END;
+}  // setEffect
+
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::setEffect (uint32_t EffectIndex)
+{
+    // DEBUG_START;
+
+    if ( (EffectIndex < NUM_EFFECTS) && (EffectIndex != ActiveEffectIndex) )
+    {
+        // DEBUG_V ("Starting Effect");
+        ActiveEffectIndex = EffectIndex;
+        ActiveEffect      = &ListOfEffects[EffectIndex];
+        UpdateEffectClock ();
+        EffectStartUs  = EffectClockUs;
+        NextFrameDueUs = EffectClockUs + ( uint64_t (EffectDelay) * 1000 );
+        EffectWait    = MIN_EFFECT_DELAY;
+        EffectCounter = 0;
+        EffectStep    = 0;
+    }
 
     // DEBUG_END;
 }  // setEffect
@@ -620,34 +807,161 @@ void c_InputEffectEngine::setColor (String & NewColor)
 }  // setColor
 
 // -----------------------------------------------------------------------------
-void c_InputEffectEngine::setPixel (uint16_t pixelId, CRGB color)
+// The SWAR helpers below work on two 8 bit values held in bits 0-7 and 16-23
+// of a uint32_t. Each lane has 8 bits of headroom for carries.
+#define LANE_MASK       0x00FF00FFUL
+#define LANE_CARRY_MASK 0x01000100UL
+
+static inline uint32_t SaturatingAddLanes (uint32_t a, uint32_t b)
 {
-    // DEBUG_START;
+    uint32_t    sum      = a + b;
+    uint32_t    overflow = sum & LANE_CARRY_MASK;
 
-    // DEBUG_V (String ("IsInputChannelActive: ") + String(IsInputChannelActive));
-    // DEBUG_V (String ("pixelId: ") + pixelId);
-    // DEBUG_V (String ("PixelCount: ") + PixelCount);
+    // turn each carry bit into 0xFF in its lane
+    return( (sum | ( overflow - (overflow >> 8) ) ) & LANE_MASK );
+} // SaturatingAddLanes
+
+static inline uint32_t MaxLanes (uint32_t a, uint32_t b)
+{
+    // the borrow bit of each lane is clear where a < b
+    uint32_t    NotBorrow = ( (a | LANE_CARRY_MASK) - b ) & LANE_CARRY_MASK;
+    uint32_t    UseA      = NotBorrow - (NotBorrow >> 8);
 
-    if ( (true == IsInputChannelActive) && (pixelId < PixelCount) )
+    return( (a & UseA) | (b & ~UseA & LANE_MASK) );
+} // MaxLanes
+
+static inline uint32_t AlphaLanes (uint32_t a, uint32_t b, uint32_t alpha256)
+{
+    return( ( ( a * (256 - alpha256) + b * alpha256 ) >> 8 ) & LANE_MASK );
+} // AlphaLanes
+
+// -----------------------------------------------------------------------------
+uint32_t c_InputEffectEngine::BlendPixel (uint32_t base, const EffectLayer_t & layer)
+{
+    uint32_t    BaseRB  = base & LANE_MASK;
+    uint32_t    BaseG   = (base >> 8) & LANE_MASK;
+    uint32_t    LayerRB = layer.Color & LANE_MASK;
+    uint32_t    LayerG  = (layer.Color >> 8) & LANE_MASK;
+    uint32_t    Response;
+
+    switch (layer.Mode)
     {
-        uint8_t PixelBuffer[sizeof (CRGB) + 1];
+    case BlendAdd :
+    {
+        Response = SaturatingAddLanes (BaseRB, LayerRB) | (SaturatingAddLanes (BaseG, LayerG) << 8);
+        break;
+    }
+
+    case BlendMax :
+    {
+        Response = MaxLanes (BaseRB, LayerRB) | (MaxLanes (BaseG, LayerG) << 8);
+        break;
+    }
 
-        // DEBUG_V(String("ChannelsPerPixel * pixelId: 0x") + String(uint(ChannelsPerPixel * pixelId), HEX));
-        // DEBUG_V (String ("EffectBrightness: ") + String (EffectBrightness));
-        // DEBUG_V (String ("color.r: ") + String (color.r));
-        // DEBUG_V (String ("color.g: ") + String (color.g));
-        // DEBUG_V (String ("color.b: ") + String (color.b));
+    case BlendMultiply :
+    {
+        // (base * (layer + 1)) >> 8 so that a layer value of 255 leaves the base unchanged
+        Response  = ( ( (base >> 16) & 0xFF ) * ( ( (layer.Color >> 16) & 0xFF ) + 1 ) >> 8 ) << 16;
+        Response |= ( ( (base >> 8) & 0xFF ) * ( ( (layer.Color >> 8) & 0xFF ) + 1 ) >> 8 ) << 8;
+        Response |= ( (base & 0xFF) * ( (layer.Color & 0xFF) + 1 ) >> 8 );
+        break;
+    }
 
-        PixelBuffer[0] = color.r * EffectBrightness;
-        PixelBuffer[1] = color.g * EffectBrightness;
-        PixelBuffer[2] = color.b * EffectBrightness;
+    case BlendAlpha :
+    {
+        // scale 0..255 to 0..256 so that full alpha is an exact copy of the layer
+        uint32_t alpha256 = uint32_t (layer.Alpha) + (layer.Alpha >> 7);
+        Response = AlphaLanes (BaseRB, LayerRB, alpha256) | (AlphaLanes (BaseG, LayerG, alpha256) << 8);
+        break;
+    }
 
-        if (4 == ChannelsPerPixel)
+    case BlendReplace :
+    default :
+    {
+        Response = layer.Color;
+        break;
+    }
+    } // switch
+
+    return(Response);
+} // BlendPixel
+
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::OutputFrame ()
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        if (false == IsInputChannelActive)
         {
-            PixelBuffer[3] = 0;  // no white data
+            // DEBUG_V ("Input is not active");
+            break;
+        }
+
+        // Pixels painted with outputEffectColor live in mirror / reverse space
+        // and get mapped to their physical location(s) here.
+        uint32_t    NumPixels           = (FrameIsMapped) ? MirroredPixelCount : PixelCount;
+        uint8_t *   pFrameOutputBuffer  = FrameOutputBuffer.data ();
+
+        for (uint32_t LogicalPixelId = 0; LogicalPixelId < NumPixels; ++LogicalPixelId)
+        {
+            uint32_t color = FrameBuffer[LogicalPixelId];
+
+            for (const EffectLayer_t & CurrentLayer : Layers)
+            {
+                if (CurrentLayer.Enabled)
+                {
+                    color = BlendPixel (color, CurrentLayer);
+                }
+            }
+
+            uint8_t PixelData[3];
+            PixelData[0] = BrightnessLut[uint8_t (color >> 16)];
+            PixelData[1] = BrightnessLut[uint8_t (color >> 8)];
+            PixelData[2] = BrightnessLut[uint8_t (color)];
+
+            uint32_t pixelId = LogicalPixelId;
+
+            if (FrameIsMapped)
+            {
+                if (EffectReverse)
+                {
+                    pixelId = (NumPixels - 1) - pixelId;
+                }
+
+                if (EffectMirror)
+                {
+                    // write the mirrored copy and fall through to the upper half
+                    memcpy (&pFrameOutputBuffer[( (NumPixels - 1) - pixelId ) * ChannelsPerPixel], PixelData, sizeof (PixelData));
+                    pixelId = (NumPixels + pixelId) - PixelOffset;
+                }
+            }
+
+            if (pixelId < PixelCount)
+            {
+                // white channel (if any) is left at zero
+                memcpy (&pFrameOutputBuffer[pixelId * ChannelsPerPixel], PixelData, sizeof (PixelData));
+            }
         }
 
-        OutputMgr.WriteChannelData (pixelId * ChannelsPerPixel, ChannelsPerPixel, PixelBuffer);
+        OutputMgr.WriteChannelData (0, FrameOutputBuffer.size (), pFrameOutputBuffer);
+    } while (false);
+
+    // DEBUG_END;
+}  // OutputFrame
+
+// -----------------------------------------------------------------------------
+void c_InputEffectEngine::setPixel (uint16_t pixelId, CRGB color)
+{
+    // DEBUG_START;
+
+    // DEBUG_V (String ("pixelId: ") + pixelId);
+    // DEBUG_V (String ("PixelCount: ") + PixelCount);
+
+    if (pixelId < PixelCount)
+    {
+        FrameBuffer[pixelId] = PackColor (color);
     }
 
     // DEBUG_END;
@@ -658,18 +972,12 @@ void c_InputEffectEngine::GetPixel (uint16_t pixelId, CRGB & out)
 {
     // DEBUG_START;
 
-    // DEBUG_V (String ("IsInputChannelActive: ") + String(IsInputChannelActive));
     // DEBUG_V (String ("pixelId: ") + pixelId);
     // DEBUG_V (String ("PixelCount: ") + PixelCount);
 
     if (pixelId < PixelCount)
     {
-        byte PixelData[sizeof (CRGB)];
-        OutputMgr.ReadChannelData (uint32_t (ChannelsPerPixel * pixelId), sizeof (PixelData), PixelData);
-
-        out.r = PixelData[0];
-        out.g = PixelData[1];
-        out.b = PixelData[2];
+        out = UnpackColor (FrameBuffer[pixelId]);
     }
 
     // DEBUG_END;
@@ -753,21 +1061,12 @@ void c_InputEffectEngine::outputEffectColor (uint16_t pixelId, CRGB outputColor)
 {
     //  DEBUG_START;
 
-    uint16_t NumPixels = MirroredPixelCount;
+    // reverse and mirror are applied when the frame is output
+    FrameIsMapped = true;
 
-    if (EffectReverse)
+    if (pixelId < MirroredPixelCount)
     {
-        pixelId = (NumPixels - 1) - pixelId;
-    }
-
-    if (EffectMirror)
-    {
-        setPixel (  (NumPixels - 1) - pixelId,                  outputColor );
-        setPixel (  ( (NumPixels) + pixelId ) - PixelOffset,    outputColor );
-    }
-    else
-    {
-        setPixel (pixelId, outputColor);
+        FrameBuffer[pixelId] = PackColor (outputColor);
     }
 
     // DEBUG_END;
@@ -786,7 +1085,7 @@ uint16_t c_InputEffectEngine::effectChase ()
 
     // Prevent errors if we come from another effect with more steps
     // or switch from the upper half of non-mirror to mirror mode
-    EffectStep = EffectStep % lc;
+    EffectStep = (EffectStep + EffectStepsDue - 1) % lc;
 
     outputEffectColor (EffectStep, EffectColor);
 
@@ -808,7 +1107,7 @@ uint16_t c_InputEffectEngine::effectRainbow ()
     uint16_t NumberOfPixelsToOutput = MirroredPixelCount;
 
     // Next step or wrap
-    if (++EffectStep >= NumberOfPixelsToOutput) {EffectStep = 0;}
+    EffectStep = (EffectStep + EffectStepsDue) % NumberOfPixelsToOutput;
 
     // DEBUG_V (String ("MirroredPixelCount: ") + String (MirroredPixelCount));
     // DEBUG_V (String ("        EffectStep: ") + String (EffectStep));
@@ -824,8 +1123,8 @@ uint16_t c_InputEffectEngine::effectRainbow ()
             if (hue > NumberOfPixelsToOutput) {hue -= NumberOfPixelsToOutput;}
         }
 
-        hue = map (hue, 0, NumberOfPixelsToOutput, 0, 359);
-        CRGB color = hsv2rgb ({double(hue), 1.0, 1.0});
+        hue = map (hue, 0, NumberOfPixelsToOutput, 0, HSV_HUE_MAX - 1);
+        CRGB color = hsv2rgb ({uint16_t (hue), 255, 255});
 
         outputEffectColor ( (NumberOfPixelsToOutput - CurrentPixelId) - 1, color );
         // outputEffectColor (CurrentPixelId, color);
@@ -838,53 +1137,42 @@ uint16_t c_InputEffectEngine::effectRainbow ()
 // -----------------------------------------------------------------------------
 uint16_t c_InputEffectEngine::effectRandom ()
 {
-    // Effect Step will be in the range zero through the number of pixels and is used
-    // to set the starting point for the colors
+    // Each pixel fades out from a random color and then picks a new one.
+    // The color of each pixel is kept in RandomPixelStates so the fade does
+    // not depend on what is currently in the output buffer.
 
     // DEBUG_START;
     // calculate only half the pixels if mirroring
-    uint16_t NumberOfPixelsToOutput = MirroredPixelCount;
+    uint16_t NumberOfPixelsToOutput = min (uint32_t (MirroredPixelCount), uint32_t (RandomPixelStates.size ()));
 
     // DEBUG_V (String ("MirroredPixelCount: ") + String (MirroredPixelCount));
 
+    // fade by 1% of full scale per step
+    const uint32_t RandomValueStep = ( (255 << 8) / 100 ) * EffectStepsDue;
+
     for (uint16_t CurrentPixelId = 0; CurrentPixelId < NumberOfPixelsToOutput; CurrentPixelId++)
     {
-        CRGB RgbColor;
-        GetPixel (CurrentPixelId, RgbColor);
-        // DEBUG_V (String ("    RgbColor.r: ") + String (RgbColor.r));
-        // DEBUG_V (String ("    RgbColor.g: ") + String (RgbColor.g));
-        // DEBUG_V (String ("    RgbColor.b: ") + String (RgbColor.b));
-
-        dCHSV HsvColor = rgb2hsv (RgbColor);
-        // DEBUG_V (String ("CurrentPixelId: ") + String (CurrentPixelId));
-        // DEBUG_V (String ("         value: ") + String (HsvColor.v));
-        // DEBUG_V (String ("    saturation: ") + String (HsvColor.s));
+        RandomPixelState & PixelState = RandomPixelStates[CurrentPixelId];
 
         // is a new color needed
-        if (HsvColor.v > 0.01)
+        if (PixelState.v > RandomValueStep)
         {
             // DEBUG_V ("adjust existing color value");
-            HsvColor.v -= 0.01;
-            // DEBUG_V (String ("         value: ") + String (HsvColor.v));
+            PixelState.v -= RandomValueStep;
         }
         else
         {
             // DEBUG_V ("set up a new color");
-            HsvColor.h = double( random (359) );
-            HsvColor.s = double( random (50, 100) ) / 100;
-            HsvColor.v = double( random (50, 100) ) / 100;
-
-            // RgbColor = hsv2rgb (HsvColor);
-            // DEBUG_V (String ("           hue: ") + String (HsvColor.h));
-            // DEBUG_V (String ("    saturation: ") + String (HsvColor.s));
-            // DEBUG_V (String ("         value: ") + String (HsvColor.v));
-            // DEBUG_V (String ("    RgbColor.r: ") + String (RgbColor.r));
-            // DEBUG_V (String ("    RgbColor.g: ") + String (RgbColor.g));
-            // DEBUG_V (String ("    RgbColor.b: ") + String (RgbColor.b));
+            PixelState.h = uint16_t ( Random.Below (HSV_HUE_MAX) );
+            PixelState.s = uint8_t ( map (Random.Range (50, 100), 0, 100, 0, 255) );
+            PixelState.v = uint16_t ( map (Random.Range (50, 100), 0, 100, 0, 255) ) << 8;
+
+            // DEBUG_V (String ("           hue: ") + String (PixelState.h));
+            // DEBUG_V (String ("    saturation: ") + String (PixelState.s));
+            // DEBUG_V (String ("         value: ") + String (PixelState.v));
         }
 
-        RgbColor = hsv2rgb (HsvColor);
-        outputEffectColor (CurrentPixelId, RgbColor);
+        outputEffectColor ( CurrentPixelId, hsv2rgb ({PixelState.h, PixelState.s, uint8_t (PixelState.v >> 8)}) );
     }
 
     // DEBUG_END;
@@ -900,49 +1188,55 @@ uint16_t c_InputEffectEngine::effectTransition ()
 
     // DEBUG_START;
 
-    if ( ColorHasReachedTarget () )
+    // run one transition step for each step that is due
+    for (uint32_t StepCount = 0; StepCount < EffectStepsDue; ++StepCount)
     {
-        // DEBUG_V("need to calculate a new target color");
+        if ( ColorHasReachedTarget () )
+        {
+            // DEBUG_V("need to calculate a new target color");
 
-        // remove any calculation errors
-        dCRGB TransitionCurrentColor = *TransitionTargetColorIterator;
+            // remove any calculation errors
+            TransitionCurrentColor.r = int32_t (TransitionTargetColorIterator->r) << 8;
+            TransitionCurrentColor.g = int32_t (TransitionTargetColorIterator->g) << 8;
+            TransitionCurrentColor.b = int32_t (TransitionTargetColorIterator->b) << 8;
 
-        ++TransitionTargetColorIterator;
+            ++TransitionTargetColorIterator;
 
-        // wrap the index
-        if ( TransitionTargetColorIterator == TransitionColorTable.end () )
-        {
-            // DEBUG_V("Wrap Transition iterator");
-            TransitionTargetColorIterator = TransitionColorTable.begin ();
-        }
+            // wrap the index
+            if ( TransitionTargetColorIterator == TransitionColorTable.end () )
+            {
+                // DEBUG_V("Wrap Transition iterator");
+                TransitionTargetColorIterator = TransitionColorTable.begin ();
+            }
 
-        CalculateTransitionStepValue (  TransitionTargetColorIterator->r,   TransitionCurrentColor.r,   TransitionStepValue.r);
-        CalculateTransitionStepValue (  TransitionTargetColorIterator->g,   TransitionCurrentColor.g,   TransitionStepValue.g);
-        CalculateTransitionStepValue (  TransitionTargetColorIterator->b,   TransitionCurrentColor.b,   TransitionStepValue.b);
-
-        // DEBUG_V(String("   TransitionStepValue.r: ") + String(TransitionStepValue.r));
-        // DEBUG_V(String("   TransitionStepValue.g: ") + String(TransitionStepValue.g));
-        // DEBUG_V(String("   TransitionStepValue.b: ") + String(TransitionStepValue.b));
-        // DEBUG_V(String("           TargetColor.r: ") + String(TransitionTargetColorIterator->r));
-        // DEBUG_V(String("           TargetColor.g: ") + String(TransitionTargetColorIterator->g));
-        // DEBUG_V(String("           TargetColor.b: ") + String(TransitionTargetColorIterator->b));
-        // DEBUG_V(String("TransitionCurrentColor.r: ") + String(TransitionCurrentColor.r));
-        // DEBUG_V(String("TransitionCurrentColor.g: ") + String(TransitionCurrentColor.g));
-        // DEBUG_V(String("TransitionCurrentColor.b: ") + String(TransitionCurrentColor.b));
-    }
-    else
-    {
-        // DEBUG_V("need to calculate next transition color");
+            CalculateTransitionStepValue (  int32_t (TransitionTargetColorIterator->r) << 8,  TransitionCurrentColor.r,   TransitionStepValue.r);
+            CalculateTransitionStepValue (  int32_t (TransitionTargetColorIterator->g) << 8,  TransitionCurrentColor.g,   TransitionStepValue.g);
+            CalculateTransitionStepValue (  int32_t (TransitionTargetColorIterator->b) << 8,  TransitionCurrentColor.b,   TransitionStepValue.b);
+
+            // DEBUG_V(String("   TransitionStepValue.r: ") + String(TransitionStepValue.r));
+            // DEBUG_V(String("   TransitionStepValue.g: ") + String(TransitionStepValue.g));
+            // DEBUG_V(String("   TransitionStepValue.b: ") + String(TransitionStepValue.b));
+            // DEBUG_V(String("           TargetColor.r: ") + String(TransitionTargetColorIterator->r));
+            // DEBUG_V(String("           TargetColor.g: ") + String(TransitionTargetColorIterator->g));
+            // DEBUG_V(String("           TargetColor.b: ") + String(TransitionTargetColorIterator->b));
+            // DEBUG_V(String("TransitionCurrentColor.r: ") + String(TransitionCurrentColor.r));
+            // DEBUG_V(String("TransitionCurrentColor.g: ") + String(TransitionCurrentColor.g));
+            // DEBUG_V(String("TransitionCurrentColor.b: ") + String(TransitionCurrentColor.b));
+        }
+        else
+        {
+            // DEBUG_V("need to calculate next transition color");
 
-        ConditionalIncrementColor ( TransitionTargetColorIterator->r,   TransitionCurrentColor.r,   TransitionStepValue.r);
-        ConditionalIncrementColor ( TransitionTargetColorIterator->g,   TransitionCurrentColor.g,   TransitionStepValue.g);
-        ConditionalIncrementColor ( TransitionTargetColorIterator->b,   TransitionCurrentColor.b,   TransitionStepValue.b);
+            ConditionalIncrementColor ( int32_t (TransitionTargetColorIterator->r) << 8,  TransitionCurrentColor.r,   TransitionStepValue.r);
+            ConditionalIncrementColor ( int32_t (TransitionTargetColorIterator->g) << 8,  TransitionCurrentColor.g,   TransitionStepValue.g);
+            ConditionalIncrementColor ( int32_t (TransitionTargetColorIterator->b) << 8,  TransitionCurrentColor.b,   TransitionStepValue.b);
+        }
     }
 
     CRGB TempColor;
-    TempColor.r = uint8_t (TransitionCurrentColor.r);
-    TempColor.g = uint8_t (TransitionCurrentColor.g);
-    TempColor.b = uint8_t (TransitionCurrentColor.b);
+    TempColor.r = uint8_t (TransitionCurrentColor.r >> 8);
+    TempColor.g = uint8_t (TransitionCurrentColor.g >> 8);
+    TempColor.b = uint8_t (TransitionCurrentColor.b >> 8);
 
     // DEBUG_V(String("r: ") + String(TempColor.r));
     // DEBUG_V(String("g: ") + String(TempColor.g));
@@ -956,109 +1250,128 @@ uint16_t c_InputEffectEngine::effectTransition ()
 }  // effectTransition
 
 // -----------------------------------------------------------------------------
-uint16_t c_InputEffectEngine::effectMarquee ()
+void c_InputEffectEngine::BuildMarqueeRing ()
 {
     // DEBUG_START;
     /*
-     *     Chase groups of pixels
-     *     Each group specifies a color and a number of pixels in the group
-     *     seperate number of pixels to advance for each iteration
-     *
+     *     Lay the groups end to end (repeating them) until every pixel has a
+     *     color. Entry k of the pattern is the k-th pixel away from the
+     *     marquee start location: downwards when going forward, upwards
+     *     when reversed.
      *
-     *     Iterate backwards through the array of pixels.
-     *     Output data for each entry in the array of groups
-     *     Advance the next output pixel forward
-     *     wait
+     *     The ring is stored so that frame pixel i is always
+     *     MarqueeRing[(i - location) % PixelCount]. For the reversed
+     *     direction that is the pattern itself. For forward the pattern is
+     *     flipped: MarqueeRing[j] = pattern[(PixelCount - j) % PixelCount].
      */
 
-    uint32_t    CurrentMarqueePixelLocation = effectMarqueePixelLocation;
-    uint32_t    NumPixelsToProcess          = PixelCount;
-    do
+    MarqueeRing.assign (PixelCount, 0);
+    MarqueeRingIsDirty = false;
+
+    uint32_t NumPixelsInTable = 0;
+    for (const MarqueeGroup & CurrentGroup : MarqueueGroupTable)
+    {
+        NumPixelsInTable += CurrentGroup.NumPixelsInGroup;
+    }
+
+    uint32_t PatternPixelId = 0;
+
+    // an empty group table leaves the ring dark
+    while ( (0 != NumPixelsInTable) && (PatternPixelId < PixelCount) )
     {
         // iterate through the groups until we have processed all of the pixels.
-        for (auto CurrentGroup : MarqueueGroupTable)
+        for (const MarqueeGroup & CurrentGroup : MarqueueGroupTable)
         {
             uint32_t    groupPixelCount    = CurrentGroup.NumPixelsInGroup;
-            double      CurrentBrightness  = (EffectReverse)?CurrentGroup.EndingIntensity : CurrentGroup.StartingIntensity;
-            double      BrightnessInterval = ( double(CurrentGroup.StartingIntensity) - double(CurrentGroup.EndingIntensity) ) / double(groupPixelCount);
 
-            // now adjust for 100% = 1
-            CurrentBrightness  /= 100;
-            BrightnessInterval /= 100;
+            // brightness is in percent, 8.8 fixed point
+            int32_t     CurrentBrightness  = int32_t ( (EffectReverse)?CurrentGroup.EndingIntensity : CurrentGroup.StartingIntensity ) << 8;
+            int32_t     BrightnessInterval = 0;
 
-            // for each pixel in the group
-            for (; (0 != groupPixelCount) && (NumPixelsToProcess); --groupPixelCount, --NumPixelsToProcess)
+            if (0 != groupPixelCount)
             {
-                CRGB color = CurrentGroup.Color;
-                color.r = uint8_t (double(color.r) * CurrentBrightness);
-                color.g = uint8_t (double(color.g) * CurrentBrightness);
-                color.b = uint8_t (double(color.b) * CurrentBrightness);
-
-                // output the current value
-                outputEffectColor (CurrentMarqueePixelLocation, color);
-
-                // advance to the next pixel
-                if (EffectReverse)
-                {
-                    // set the next brightness
-                    CurrentBrightness += BrightnessInterval;
-
-                    ++CurrentMarqueePixelLocation;
-
-                    if (PixelCount <= CurrentMarqueePixelLocation)
-                    {
-                        // wrap bottom of the buffer
-                        CurrentMarqueePixelLocation = 0;
-                    }
-                }
-                else  // forward
-                {
-                    // set the next brightness
-                    CurrentBrightness -= BrightnessInterval;
-
-                    if (0 == CurrentMarqueePixelLocation)
-                    {
-                        // wrap one past the top of the buffer
-                        CurrentMarqueePixelLocation = PixelCount;
-                    }
+                BrightnessInterval = ( (int32_t (CurrentGroup.StartingIntensity) - int32_t (CurrentGroup.EndingIntensity) ) << 8 ) / int32_t (groupPixelCount);
+            }
 
-                    --CurrentMarqueePixelLocation;
-                }
+            if (!EffectReverse)
+            {
+                BrightnessInterval = 0 - BrightnessInterval;
             }
 
-            // did we stop due to pixel exhaustion
-            if (0 == NumPixelsToProcess)
+            // for each pixel in the group
+            for (; (0 != groupPixelCount) && (PatternPixelId < PixelCount); --groupPixelCount, ++PatternPixelId)
             {
-                break;
+                CRGB    color   = CurrentGroup.Color;
+                int32_t scale   = constrain (CurrentBrightness, int32_t (0), int32_t (100 << 8));
+                color.r = uint8_t ( (int32_t (color.r) * scale) / (100 << 8) );
+                color.g = uint8_t ( (int32_t (color.g) * scale) / (100 << 8) );
+                color.b = uint8_t ( (int32_t (color.b) * scale) / (100 << 8) );
+
+                uint32_t RingId = (EffectReverse) ? PatternPixelId : ( (PixelCount - PatternPixelId) % PixelCount );
+                MarqueeRing[RingId] = PackColor (color);
+
+                // set the next brightness
+                CurrentBrightness += BrightnessInterval;
             }
         }
-    } while (NumPixelsToProcess);
+    }
 
-    // advance to the next starting location
-    effectMarqueePixelLocation += effectMarqueePixelAdvanceCount;
+    // DEBUG_END;
+}  // BuildMarqueeRing
 
-    if (effectMarqueePixelLocation >= PixelCount)
+// -----------------------------------------------------------------------------
+uint16_t c_InputEffectEngine::effectMarquee ()
+{
+    // DEBUG_START;
+    /*
+     *     Chase groups of pixels
+     *     Each group specifies a color and a number of pixels in the group
+     *     seperate number of pixels to advance for each iteration
+     *
+     *     The pattern only changes with the config, so it is built once into
+     *     MarqueeRing and each frame is the ring rotated to the current
+     *     start location (at most two copies).
+     */
+
+    if (MarqueeRingIsDirty || (MarqueeRing.size () != PixelCount) )
     {
-        // wrap around
-        effectMarqueePixelLocation -= PixelCount;
+        BuildMarqueeRing ();
     }
 
+    // catch up on any steps that were skipped
+    effectMarqueePixelLocation = ( effectMarqueePixelLocation + (effectMarqueePixelAdvanceCount * (EffectStepsDue - 1) ) ) % PixelCount;
+
+    // pixels are written in marquee space and then reversed / mirrored at output
+    FrameIsMapped = true;
+
+    uint32_t    Location    = effectMarqueePixelLocation;
+    uint32_t    TailLength  = PixelCount - Location;
+
+    // frame[Location .. PixelCount) = ring[0 .. TailLength)
+    // frame[0 .. Location)          = ring[TailLength .. PixelCount)
+    memcpy (FrameBuffer.data () + Location, MarqueeRing.data (),              TailLength * sizeof (uint32_t) );
+    memcpy (FrameBuffer.data (),            MarqueeRing.data () + TailLength, Location   * sizeof (uint32_t) );
+
+    // advance to the next starting location and wrap around
+    effectMarqueePixelLocation = (effectMarqueePixelLocation + effectMarqueePixelAdvanceCount) % PixelCount;
+
     // DEBUG_END;
     return(EffectDelay / 10);
     //    return 1;
-}  // effectTransition
+}  // effectMarquee
 
 // -----------------------------------------------------------------------------
-void c_InputEffectEngine::CalculateTransitionStepValue (double tc, double cc, double & step)
+// tc, cc and step are 8.8 fixed point
+void c_InputEffectEngine::CalculateTransitionStepValue (int32_t tc, int32_t cc, int32_t & step)
 {
     // DEBUG_START;
     step = (tc - cc) / NumStepsToTarget;
 
-    #define MinStepValue (1.0 / NumStepsToTarget)
+    #define MinStepValue 1
 
-    if ( MinStepValue > fabs (step) )
+    if ( MinStepValue > abs (step) )
     {
-        if (step < 0.0)
+        if ( (tc - cc) < 0 )
         {
             step = 0 - MinStepValue;
         }
@@ -1076,19 +1389,19 @@ void c_InputEffectEngine::CalculateTransitionStepValue (double tc, double cc, do
 } // c_InputEffectEngine::CalculateTransitionStepValue
 
 // -----------------------------------------------------------------------------
-void c_InputEffectEngine::ConditionalIncrementColor (double tc, double & cc, double step)
+void c_InputEffectEngine::ConditionalIncrementColor (int32_t tc, int32_t & cc, int32_t step)
 {
     // DEBUG_START;
 
-    double originalDiff = fabs (tc - cc);
+    int32_t originalDiff = abs (tc - cc);
 
     if ( !ColorHasReachedTarget (tc, cc, step) )
     {
-        cc = min ( (cc + step), 255.0 );
-        cc = max (0.0, cc);
+        cc = min ( (cc + step), int32_t (255 << 8) );
+        cc = max (int32_t (0), cc);
     }
 
-    double NewDiff = fabs (tc - cc);
+    int32_t NewDiff = abs (tc - cc);
 
     if (NewDiff > originalDiff)
     {
@@ -1104,15 +1417,15 @@ void c_InputEffectEngine::ConditionalIncrementColor (double tc, double & cc, dou
 } // c_InputEffectEngine::ConditionalIncrementColor
 
 // -----------------------------------------------------------------------------
-bool c_InputEffectEngine::ColorHasReachedTarget (double tc, double cc, double step)
+bool c_InputEffectEngine::ColorHasReachedTarget (int32_t tc, int32_t cc, int32_t step)
 {
     // DEBUG_START;
 
     bool    response = false;
 
-    double  diff = fabs (tc - cc);
+    int32_t diff = abs (tc - cc);
 
-    if ( diff <= fabs (2 * step) )
+    if ( diff <= abs (2 * step) )
     {
         // DEBUG_V("Single Color has reached target")
         response = true;
@@ -1136,9 +1449,9 @@ bool c_InputEffectEngine::ColorHasReachedTarget ()
 {
     // DEBUG_START;
 
-    bool response = ( ColorHasReachedTarget (TransitionTargetColorIterator->r, TransitionCurrentColor.r, TransitionStepValue.r) &&
-        ColorHasReachedTarget ( TransitionTargetColorIterator->g,   TransitionCurrentColor.g,   TransitionStepValue.g) &&
-        ColorHasReachedTarget ( TransitionTargetColorIterator->b,   TransitionCurrentColor.b,   TransitionStepValue.b) );
+    bool response = ( ColorHasReachedTarget (int32_t (TransitionTargetColorIterator->r) << 8, TransitionCurrentColor.r, TransitionStepValue.r) &&
+        ColorHasReachedTarget ( int32_t (TransitionTargetColorIterator->g) << 8,  TransitionCurrentColor.g,   TransitionStepValue.g) &&
+        ColorHasReachedTarget ( int32_t (TransitionTargetColorIterator->b) << 8,  TransitionCurrentColor.b,   TransitionStepValue.b) );
 
     if (response)
     {
@@ -1155,6 +1468,8 @@ uint16_t c_InputEffectEngine::effectBlink ()
     // DEBUG_START;
     // The Blink effect uses two "time slots": on, off
     // Using default delay, a complete sequence takes 2s.
+    EffectStep += EffectStepsDue - 1;
+
     if (EffectStep & 0x1)
     {
         clearAll ();
@@ -1177,7 +1492,7 @@ uint16_t c_InputEffectEngine::effectFlash ()
     // The Flash effect uses 6 "time slots": on, off, on, off, off, off
     // Using default delay, a complete sequence takes 2s.
     // Prevent errors if we come from another effect with more steps
-    EffectStep = EffectStep % 6;
+    EffectStep = (EffectStep + EffectStepsDue - 1) % 6;
 
     switch (EffectStep)
     {
@@ -1210,7 +1525,7 @@ uint16_t c_InputEffectEngine::effectFireFlicker ()
 
     for (uint16_t i = 0; i < PixelCount; i++)
     {
-        uint8_t flicker = random (lum);
+        uint8_t flicker = Random.Below (lum);
         setPixel (
             i,
             CRGB{
@@ -1233,8 +1548,8 @@ uint16_t c_InputEffectEngine::effectLightning ()
     static byte maxFlashes;
     static int  timeslot = EffectDelay / 1000;      // 1ms
     int         flashPause       = 10;              // 10ms
-    uint16_t    ledStart    = random (PixelCount);
-    uint16_t    ledLen      = random (1, PixelCount - ledStart);
+    uint16_t    ledStart    = Random.Below (PixelCount);
+    uint16_t    ledLen      = Random.Range (1, PixelCount - ledStart);
     uint32_t    intensity; // flash intensity
 
     if (EffectStep % 2)
@@ -1249,7 +1564,7 @@ uint16_t c_InputEffectEngine::effectLightning ()
         }
         else
         {
-            flashPause = random (50, 151);  // pause between flashes 50-150ms
+            flashPause = Random.Range (50, 151);  // pause between flashes 50-150ms
         }
     }
     else
@@ -1258,13 +1573,13 @@ uint16_t c_InputEffectEngine::effectLightning ()
         if (EffectStep == 0)
         {
             // FirstPixelId flash (weaker and longer pause)
-            maxFlashes = random (3, 8);  // 2-6 follow-up flashes
-            intensity  = random (128);
+            maxFlashes = Random.Range (3, 8);  // 2-6 follow-up flashes
+            intensity  = Random.Below (128);
         }
         else
         {
             // follow-up flashes (stronger)
-            intensity = random (128, 256);  // next flashes are stronger
+            intensity = Random.Range (128, 256);  // next flashes are stronger
         }
 
         CRGB temprgb =
@@ -1274,7 +1589,7 @@ uint16_t c_InputEffectEngine::effectLightning ()
             uint8_t (   uint32_t (EffectColor.b) * intensity / 256)
         };
         setRange (ledStart, ledLen, temprgb);
-        flashPause = random (4, 21);  // flash duration 4-20ms
+        flashPause = Random.Range (4, 21);  // flash duration 4-20ms
     }
 
     EffectStep++;
@@ -1282,7 +1597,7 @@ uint16_t c_InputEffectEngine::effectLightning ()
     if (EffectStep >= maxFlashes * 2)
     {
         EffectStep = 0;
-        flashPause = random (100, 5001);  // between 0.1 and 5s
+        flashPause = Random.Range (100, 5001);  // between 0.1 and 5s
     }
 
     // DEBUG_END;
@@ -1314,7 +1629,7 @@ uint16_t c_InputEffectEngine::effectBreathe ()
      */
     // sin() is in radians, so 2*PI rad is a full period; compiler should optimize.
     // DEBUG_START;
-    float val = (exp ( sin (float( millis () ) / (float(EffectDelay) * 5.0) * 2.0 * PI) ) - 0.367879441) * 0.106364766 + 0.75;
+    float val = (exp ( sin (float( EffectElapsedUs / 1000 ) / (float(EffectDelay) * 5.0) * 2.0 * PI) ) - 0.367879441) * 0.106364766 + 0.75;
     setAll (
     {
         uint8_t (   EffectColor.r * val),
@@ -1327,13 +1642,18 @@ uint16_t c_InputEffectEngine::effectBreathe ()
 } // c_InputEffectEngine::effectBreathe
 
 // -----------------------------------------------------------------------------
-// dCHSV hue 0->360 sat 0->1.0 val 0->1.0
-c_InputEffectEngine::dCHSV c_InputEffectEngine::rgb2hsv (CRGB in_int)
+// rounded x / 255 for 0 <= x <= 65535
+static inline uint8_t div255 (uint32_t x)
+{
+    return( uint8_t ( ( x + 128 + ( (x + 128) >> 8 ) ) >> 8 ) );
+} // div255
+
+// -----------------------------------------------------------------------------
+// CHSV hue 0->1535 sat 0->255 val 0->255
+c_InputEffectEngine::CHSV c_InputEffectEngine::rgb2hsv (CRGB in)
 {
-    dCHSV   out;
-    dCRGB   in =
-    {double(in_int.r) / double(255.0), double(in_int.g) / double(255.0), double(in_int.b) / double(255.0)};
-    double  min, max, delta;
+    CHSV    out;
+    uint8_t min, max, delta;
 
     min = in.r < in.g?in.r : in.g;
     min = min < in.b?min : in.b;
@@ -1344,134 +1664,101 @@ c_InputEffectEngine::dCHSV c_InputEffectEngine::rgb2hsv (CRGB in_int)
     out.v = max;
     delta = max - min;
 
-    if (delta < 0.00001)
+    if (0 == delta)
     {
+        // grey (or black). Hue is undefined
         out.s = 0;
-        out.h = 0;   // undefined, maybe nan?
+        out.h = 0;
 
         return(out);
     }
 
-    if (max > 0.0)              // NOTE: if Max is == 0, this divide would cause a crash
-    {
-        out.s = (delta / max);  // s
-    }
-    else
-    {
-        // if max is 0, then r = g = b = 0
-        // s = 0, v is undefined
-        out.s = 0.0;
-        out.h = NAN;                              // its now undefined
+    out.s = uint8_t ( (uint32_t (delta) * 255 + (max / 2) ) / max );
 
-        return(out);
-    }
+    int32_t hue;
 
-    if (in.r >= max)                            // > is bogus, just keeps compilor happy
+    if (in.r == max)
     {
-        out.h = (in.g - in.b) / delta;          // between yellow & magenta
+        hue = ( (int32_t (in.g) - int32_t (in.b) ) * HSV_HUE_SECTOR_SIZE) / delta;                                 // between yellow & magenta
     }
     else
-    if (in.g >= max)
+    if (in.g == max)
     {
-        out.h = 2.0 + (in.b - in.r) / delta;  // between cyan & yellow
+        hue = (2 * HSV_HUE_SECTOR_SIZE) + ( (int32_t (in.b) - int32_t (in.r) ) * HSV_HUE_SECTOR_SIZE) / delta;     // between cyan & yellow
     }
     else
     {
-        out.h = 4.0 + (in.r - in.g) / delta;  // between magenta & cyan
+        hue = (4 * HSV_HUE_SECTOR_SIZE) + ( (int32_t (in.r) - int32_t (in.g) ) * HSV_HUE_SECTOR_SIZE) / delta;     // between magenta & cyan
     }
 
-    out.h *= 60.0;                              // degrees
+    if (hue < 0) {hue += HSV_HUE_MAX;}
 
-    if (out.h < 0.0) out.h += 360.0;
+    out.h = uint16_t (hue);
 
     return(out);
 } // c_InputEffectEngine::rgb2hsv
 
 // -----------------------------------------------------------------------------
-// dCHSV hue 0->360 sat 0->1.0 val 0->1.0
-c_InputEffectEngine::CRGB c_InputEffectEngine::hsv2rgb (dCHSV in)
+// CHSV hue 0->1535 sat 0->255 val 0->255
+// The upper byte of the hue selects the color wheel sector and the lower byte
+// is the position within that sector, so no division is needed to find either.
+c_InputEffectEngine::CRGB c_InputEffectEngine::hsv2rgb (CHSV in)
 {
-    double  hh, p, q, t, ff;
-    long    i;
-    dCRGB   out;
-    CRGB    out_int =
-    {0, 0, 0};
+    CRGB out =
+    {in.v, in.v, in.v};
 
-    if (in.s <= 0.0)       // < is bogus, just shuts up warnings
-    {
-        out.r = in.v;
-        out.g = in.v;
-        out.b = in.v;
-    }
-    else
+    if (0 != in.s)
     {
-        hh = in.h;
+        uint16_t hh = in.h;
 
-        if (hh >= 360.0) hh = 0.0;
+        if (hh >= HSV_HUE_MAX) {hh = 0;}
 
-        hh /= 60.0;
-        i   = (long)hh;
-        ff  = hh - i;
-        p   = in.v * (1.0 - in.s);
-        q   = in.v * ( 1.0 - (in.s * ff) );
-        t   = in.v * ( 1.0 - ( in.s * (1.0 - ff) ) );
+        uint8_t sector   = uint8_t (hh >> 8);
+        uint8_t fraction = uint8_t (hh & 0xff);
+        uint8_t p        = div255 ( in.v * uint32_t (255 - in.s) );
+        uint8_t q        = div255 ( in.v * uint32_t ( 255 - div255 (in.s * uint32_t (fraction) ) ) );
+        uint8_t t        = div255 ( in.v * uint32_t ( 255 - div255 ( in.s * uint32_t (255 - fraction) ) ) );
 
-        switch (i)
+        switch (sector)
         {
         case 0 :
         {
-            out.r = in.v;
-            out.g = t;
-            out.b = p;
+            out = {in.v, t, p};
             break;
         }
 
         case 1 :
         {
-            out.r = q;
-            out.g = in.v;
-            out.b = p;
+            out = {q, in.v, p};
             break;
         }
 
         case 2 :
         {
-            out.r = p;
-            out.g = in.v;
-            out.b = t;
+            out = {p, in.v, t};
             break;
         }
 
         case 3 :
         {
-            out.r = p;
-            out.g = q;
-            out.b = in.v;
+            out = {p, q, in.v};
             break;
         }
 
         case 4 :
         {
-            out.r = t;
-            out.g = p;
-            out.b = in.v;
+            out = {t, p, in.v};
             break;
         }
 
         case 5 :
         default :
         {
-            out.r = in.v;
-            out.g = p;
-            out.b = q;
+            out = {in.v, p, q};
             break;
         }
         } // switch
     }
 
-    out_int.r = min ( uint16_t (255), uint16_t (255 * out.r) );
-    out_int.g = min ( uint16_t (255), uint16_t (255 * out.g) );
-    out_int.b = min ( uint16_t (255), uint16_t (255 * out.b) );
-
-    return(out_int);
+    return(out);
 } // c_InputEffectEngine::hsv2rgb
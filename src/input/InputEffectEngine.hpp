@@ -19,6 +19,8 @@
  */
 
 #include "InputCommon.hpp"
+#include "BrightnessLut.hpp"
+#include "FastRandom.hpp"
 #include <vector>
 
 class c_InputEffectEngine : public c_InputCommon {
@@ -30,22 +32,6 @@ virtual~c_InputEffectEngine ();
 
 c_InputEffectEngine ();
 
-// dCRGB red, green, blue 0->1.0
-struct dCRGB
-{
-    double r;
-    double g;
-    double b;
-    dCRGB operator= (dCRGB a)
-    {
-        r = a.r;
-        g = a.g;
-        b = a.b;
-
-        return(a);
-    } // =
-};
-
 // CRGB red, green, blue 0->255
 struct CRGB
 {
@@ -54,19 +40,43 @@ struct CRGB
     uint8_t b;
 };
 
-// dCHSV hue 0->360 sat 0->1.0 val 0->1.0
-struct dCHSV
+// FCRGB red, green, blue 0->255 in 8.8 fixed point
+struct FCRGB
 {
-    double h;
-    double s;
-    double v;
+    int32_t r;
+    int32_t g;
+    int32_t b;
 };
 
+// CHSV hue 0->1535 (sector in the upper byte, position in the sector in the lower byte)
+//      sat 0->255 val 0->255
+struct CHSV
+{
+    uint16_t h;
+    uint8_t s;
+    uint8_t v;
+};
+
+    #define HSV_HUE_SECTOR_SIZE 256
+    #define HSV_HUE_MAX         (6 * HSV_HUE_SECTOR_SIZE)
+
+// Plain conversions. Public so the host test can check them (host/HsvConversionTest.cpp)
+static CHSV rgb2hsv (CRGB in);
+static CRGB hsv2rgb (CHSV in);
+
 typedef uint16_t(c_InputEffectEngine::* EffectFunc)(void);
 
+// Case insensitive FNV-1a hash of an effect name. Usable at compile time.
+static constexpr uint32_t EffectNameHash (const char * name, uint32_t hash = 2166136261UL)
+{
+    return( (0 == *name) ? hash :
+        EffectNameHash ( name + 1, ( hash ^ uint8_t ( ( (*name >= 'A') && (*name <= 'Z') ) ? (*name + ('a' - 'A') ) : *name) ) * 16777619UL ) );
+}
+
 typedef struct EffectDescriptor_s
 {
-    String name;
+    const char* name;
+    uint32_t nameHash;
     EffectFunc func;
     const char* htmlid;
     bool hasColor;
@@ -74,7 +84,7 @@ typedef struct EffectDescriptor_s
     bool hasReverse;
     bool hasAllLeds;
     bool hasWhiteChannel;
-    String wsTCode;
+    const char* wsTCode;
 } EffectDescriptor_t;
 
 typedef struct MQTTConfiguration_s
@@ -87,6 +97,14 @@ typedef struct MQTTConfiguration_s
     CRGB color;
 } MQTTConfiguration_s;
 
+// RandomPixelState hue 0->1535 sat 0->255 val 0->255 in 8.8 fixed point
+struct RandomPixelState
+{
+    uint16_t h;
+    uint8_t s;
+    uint16_t v;
+};
+
 struct MarqueeGroup
 {
     uint32_t NumPixelsInGroup;
@@ -134,6 +152,7 @@ bool HasBeenInitialized = false;
     #define MIN_EFFECT_DELAY        10
     #define MAX_EFFECT_DELAY        65535
     #define DEFAULT_EFFECT_DELAY    1000
+    #define EFFECT_CLOCK_MAX_GAP_US 1000000     /* a longer gap between calls to Process means the input was paused */
 
 using timeType = decltype( millis () );
 
@@ -147,20 +166,108 @@ bool EffectReverse      = false;                            /* Externally contro
 bool EffectMirror       = false;                            /* Externally controlled effect mirroring (start at center) */
 bool EffectAllLeds      = false;                            /* Externally controlled effect all leds = 1st led */
 bool EffectWhiteChannel = false;
-float EffectBrightness   = 1.0;                             /* Externally controlled effect brightness [0, 255] */
+float EffectBrightness   = 1.0;                             /* Externally controlled effect brightness [0, 1.0] */
+float EffectGamma        = BRIGHTNESS_LUT_DEFAULT_GAMMA;    /* Externally controlled gamma curve [1.0, 3.0] */
+c_BrightnessLut BrightnessLut;                              /* Brightness and gamma applied at output time */
 CRGB EffectColor        = {183, 0, 255};                    /* Externally controlled effect color */
 bool StayDark           = false;
+uint32_t EffectSeed     = 0;                                /* Random number seed. 0 = different every boot */
+c_FastRandom Random;
+void SeedRandom ();
 
 uint32_t effectMarqueePixelAdvanceCount = 1;
 uint32_t effectMarqueePixelLocation     = 0;
+std::vector <uint32_t> MarqueeRing;                 /* Marquee pattern in output order, rotated by effectMarqueePixelLocation */
+bool MarqueeRingIsDirty                 = true;
+void BuildMarqueeRing ();
 
 uint32_t EffectStep         = 0;                    /* Shared mutable effect step counter */
+uint32_t EffectStepsDue     = 1;                    /* Number of effect steps to advance in this frame */
 uint32_t PixelCount         = 0;                    /* Number of RGB leds (not channels) */
 uint32_t MirroredPixelCount = 0;                    /* Number of RGB leds (not channels) */
 uint8_t ChannelsPerPixel   = 3;
 uint32_t PixelOffset        = 0;
-FastTimer EffectDelayTimer;
 
+bool EffectTimeBased            = false;            /* Advance effects by elapsed time and drop frames when late */
+uint64_t EffectClockUs          = 0;                /* Monotonic effect clock */
+uint32_t EffectClockLastMicros  = 0;
+bool EffectClockResynced        = true;             /* Process was not called for a while. The next frame is not late */
+uint64_t EffectStartUs          = 0;                /* Effect clock when the active effect was started */
+uint64_t EffectElapsedUs        = 0;                /* Time since the active effect was started */
+uint64_t NextFrameDueUs         = 0;                /* Effect clock when the next frame should be rendered */
+uint32_t FrameDeadlineMisses    = 0;                /* Number of frames that were not rendered on time */
+
+// Render time statistics, one entry per effect
+struct RenderStats_t
+{
+    uint32_t Frames  = 0;
+    uint32_t MinUs   = uint32_t (-1);
+    uint32_t MaxUs   = 0;
+    uint64_t TotalUs = 0;
+
+    void Add (uint32_t DurationUs)
+    {
+        ++Frames;
+        TotalUs += DurationUs;
+        MinUs    = min (MinUs, DurationUs);
+        MaxUs    = max (MaxUs, DurationUs);
+    }
+};
+std::vector <RenderStats_t> EffectRenderStats;
+RenderStats_t OutputFrameStats;
+void GetRenderStats (JsonObject & jsonStats, const RenderStats_t & Stats);
+
+void UpdateEffectClock ();
+
+std::vector <uint32_t> FrameBuffer;                 /* Logical pixel colors (0x00RRGGBB) rendered by the active effect */
+std::vector <uint8_t> FrameOutputBuffer;            /* Channel data sent to the output manager */
+bool FrameIsMapped      = false;                    /* Frame was painted in mirror / reverse space */
+std::vector <RandomPixelState> RandomPixelStates;   /* Per pixel color state for effectRandom */
+
+// Layers are composed over the base effect frame in LayerId order
+enum BlendMode_t : uint8_t
+{
+    BlendReplace = 0,
+    BlendAdd,
+    BlendMax,
+    BlendMultiply,
+    BlendAlpha,
+    BlendModeCount,
+};
+
+struct EffectLayer_t
+{
+    bool Enabled      = false;
+    BlendMode_t Mode  = BlendReplace;
+    uint32_t Color    = 0;                          /* 0x00RRGGBB */
+    uint8_t Alpha     = 255;                        /* Used by BlendAlpha */
+};
+
+enum LayerId_t
+{
+    LayerFlash = 0,
+    LayerMasterDimmer,
+    LayerCount,
+};
+
+EffectLayer_t Layers[LayerCount];
+uint32_t MasterDimmer = 100;                        /* Externally controlled dimmer applied after all effects [0, 100] */
+
+static inline uint32_t PackColor (CRGB color)
+{
+    return( (uint32_t (color.r) << 16) | (uint32_t (color.g) << 8) | uint32_t (color.b) );
+}
+
+static inline CRGB UnpackColor (uint32_t color)
+{
+    CRGB Response = {uint8_t (color >> 16), uint8_t (color >> 8), uint8_t (color)};
+
+    return(Response);
+}
+
+uint32_t BlendPixel (uint32_t base,
+ const EffectLayer_t &        layer);
+void OutputFrame ();
 void setPixel (uint16_t idx,
  CRGB                   color);
 void GetPixel (uint16_t pixelId,
@@ -175,34 +282,35 @@ void outputEffectColor (uint16_t    pixelId,
  CRGB                               outputColor);
 
 CRGB colorWheel (uint8_t pos);
-dCHSV rgb2hsv (CRGB in);
-CRGB hsv2rgb (dCHSV in);
 
 void setColor (String & NewColor);
 void setEffect (const String & effectName);
+void setEffect (uint32_t EffectIndex);
+uint32_t FindEffect (const char * effectName);
 void setBrightness (float brightness);
 void setSpeed (uint16_t speed);
 void setDelay (uint16_t delay);
-void PollFlash ();
+bool PollFlash ();
 
 void clearAll ();
 
 const EffectDescriptor_t* ActiveEffect = nullptr;
+uint32_t ActiveEffectIndex = 0;
 
-dCRGB TransitionCurrentColor = {0.0, 0.0, 0.0};
-std::vector <c_InputEffectEngine::dCRGB>::iterator TransitionTargetColorIterator;
-dCRGB TransitionStepValue = {2.0, 2.0, 2.0};
-    #define NumStepsToTarget 300.0
+FCRGB TransitionCurrentColor = {0, 0, 0};
+std::vector <c_InputEffectEngine::CRGB>::iterator TransitionTargetColorIterator;
+FCRGB TransitionStepValue = {2 << 8, 2 << 8, 2 << 8};
+    #define NumStepsToTarget 300
 bool ColorHasReachedTarget ();
-bool ColorHasReachedTarget (double  tc,
- double                             cc,
- double                             step);
-void ConditionalIncrementColor (double  tc,
- double &                               cc,
- double                                 step);
-void CalculateTransitionStepValue (double   tc,
- double                                     cc,
- double &                                   step);
+bool ColorHasReachedTarget (int32_t tc,
+ int32_t                            cc,
+ int32_t                            step);
+void ConditionalIncrementColor (int32_t tc,
+ int32_t &                              cc,
+ int32_t                                step);
+void CalculateTransitionStepValue (int32_t  tc,
+ int32_t                                    cc,
+ int32_t &                                  step);
 
 struct FlashInfo_t
 {
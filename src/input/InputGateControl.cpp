@@ -119,6 +119,17 @@ void c_InputGateControl::Begin ()
     },
      this);
 
+    // audio handler
+    GateAudio.RegisterEventHandler(
+     [] (void* UserInfo, uint8_t Event)
+    {
+        if (UserInfo)
+        {
+            static_cast <c_InputGateControl*> (UserInfo)->Audio_Event (Event);
+        }
+    },
+     this);
+
     HasBeenInitialized = true;
 
     validateConfiguration ();
@@ -178,6 +189,43 @@ void c_InputGateControl::Button_Stop_Pressed ()
     // DEBUG_END;
 } // c_InputGateControl::Button_Stop_Pressed
 
+// -----------------------------------------------------------------------------
+void c_InputGateControl::Audio_Event (uint8_t Event)
+{
+    // DEBUG_START;
+
+    if(nullptr != CurrentFsmState)
+    {
+        switch (Event)
+        {
+            case c_GateAudio::AudioEventTrackFinished :
+            {
+                CurrentFsmState->Audio_Track_Finished(this);
+                break;
+            }
+
+            case c_GateAudio::AudioEventCardRemoved :
+            {
+                CurrentFsmState->Audio_Card_Removed(this);
+                break;
+            }
+
+            case c_GateAudio::AudioEventError :
+            {
+                CurrentFsmState->Audio_Error(this);
+                break;
+            }
+
+            default :
+            {
+                break;
+            }
+        } // switch
+    }
+
+    // DEBUG_END;
+} // c_InputGateControl::Audio_Event
+
 // -----------------------------------------------------------------------------
 void c_InputGateControl::GetConfig (JsonObject & jsonConfig)
 {
@@ -311,6 +359,26 @@ void FsmInputGateCommon::init(c_InputGateControl* pParent, String name)
 
 } // FsmInputGateCommon::init
 
+// -----------------------------------------------------------------------------
+void FsmInputGateCommon::Audio_Card_Removed (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    logcon(String( F("Audio card removed in state: '") ) + name() + "'");
+
+    // DEBUG_END;
+} // FsmInputGateCommon::Audio_Card_Removed
+
+// -----------------------------------------------------------------------------
+void FsmInputGateCommon::Audio_Error (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    logcon(String( F("Audio player error in state: '") ) + name() + "'");
+
+    // DEBUG_END;
+} // FsmInputGateCommon::Audio_Error
+
 // -----------------------------------------------------------------------------
 void FsmInputGateBooting::init(c_InputGateControl* pParent)
 {
@@ -406,23 +474,45 @@ void FsmInputGateOpeningIntro::poll(c_InputGateControl* pParent)
 {
     // _ DEBUG_START;
 
-    uint32_t now = millis();
-
-    if( 1000 < abs( int(now - pParent->fsmTimer) ) )
-    {
-        pParent->fsmTimer += 1000;
-
-        // When audio completes, next state
-        if( GateAudio.IsIdle() )
-        {
-            // DEBUG_V("Audio is idle");
-            FsmInputGateOpening_Imp.init(pParent);
-        }
-    }
+    // No Actions. Waits for the intro to finish
 
     // _ DEBUG_END;
 } // FsmInputGateOpeningIntro::init
 
+// -----------------------------------------------------------------------------
+void FsmInputGateOpeningIntro::Audio_Track_Finished (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    // DEBUG_V("Intro is done");
+    FsmInputGateOpening_Imp.init(pParent);
+
+    // DEBUG_END;
+} // FsmInputGateOpeningIntro::Audio_Track_Finished
+
+// -----------------------------------------------------------------------------
+void FsmInputGateOpeningIntro::Audio_Card_Removed (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    // the intro is not going to finish. Do not leave the gate waiting for it
+    FsmInputGateCommon::Audio_Card_Removed(pParent);
+    FsmInputGateOpening_Imp.init(pParent);
+
+    // DEBUG_END;
+} // FsmInputGateOpeningIntro::Audio_Card_Removed
+
+// -----------------------------------------------------------------------------
+void FsmInputGateOpeningIntro::Audio_Error (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    FsmInputGateCommon::Audio_Error(pParent);
+    FsmInputGateOpening_Imp.init(pParent);
+
+    // DEBUG_END;
+} // FsmInputGateOpeningIntro::Audio_Error
+
 // -----------------------------------------------------------------------------
 void FsmInputGateOpeningIntro::Button_Open_Pressed (c_InputGateControl* pParent)
 {
@@ -452,20 +542,6 @@ void FsmInputGateOpening::poll(c_InputGateControl* pParent)
 {
     // _ DEBUG_START;
 
-    uint32_t now = millis();
-
-    if( 1000 < abs( int(now - pParent->fsmTimer) ) )
-    {
-        pParent->fsmTimer += 1000;
-
-        // if the current song has completed, move to the next one
-        if( GateAudio.IsIdle() )
-        {
-            // DEBUG_V("Audio is idle");
-            GateAudio.NextSong();
-        }
-    }
-
     // Wait until the gate is open
     if( GateDoors.IsOpen() )
     {
@@ -475,6 +551,17 @@ void FsmInputGateOpening::poll(c_InputGateControl* pParent)
     // _ DEBUG_END;
 } // FsmInputGateOpening::init
 
+// -----------------------------------------------------------------------------
+void FsmInputGateOpening::Audio_Track_Finished (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    // the current song has completed, move to the next one
+    GateAudio.NextSong();
+
+    // DEBUG_END;
+} // FsmInputGateOpening::Audio_Track_Finished
+
 // -----------------------------------------------------------------------------
 void FsmInputGateOpening::Button_Open_Pressed (c_InputGateControl* pParent)
 {
@@ -504,23 +591,22 @@ void FsmInputGateOpen::poll(c_InputGateControl* pParent)
 {
     // _ DEBUG_START;
 
-    uint32_t now = millis();
-
-    if( 1000 < abs( int(now - pParent->fsmTimer) ) )
-    {
-        pParent->fsmTimer += 1000;
-
-        // if the current song has completed, move to the next one
-        if( GateAudio.IsIdle() )
-        {
-            // DEBUG_V("Audio is idle");
-            GateAudio.NextSong();
-        }
-    }
+    // No Actions
 
     // _ DEBUG_END;
 } // FsmInputGateOpen::init
 
+// -----------------------------------------------------------------------------
+void FsmInputGateOpen::Audio_Track_Finished (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    // the current song has completed, move to the next one
+    GateAudio.NextSong();
+
+    // DEBUG_END;
+} // FsmInputGateOpen::Audio_Track_Finished
+
 // -----------------------------------------------------------------------------
 void FsmInputGateOpen::Button_Open_Pressed (c_InputGateControl* pParent)
 {
@@ -643,6 +729,12 @@ void FsmInputGatePlaying::init(c_InputGateControl* pParent)
 
     FsmInputGateCommon::init( pParent, name() );
 
+    // start a song unless we are resuming one
+    if( GateAudio.IsIdle() )
+    {
+        GateAudio.PlayCurrentSelection();
+    }
+
     // DEBUG_END;
 } // FsmInputGatePlaying::init
 
@@ -650,23 +742,35 @@ void FsmInputGatePlaying::init(c_InputGateControl* pParent)
 void FsmInputGatePlaying::poll(c_InputGateControl* pParent)
 {
     // _ DEBUG_START;
-    uint32_t now = millis();
-
-    if( 1000 < abs( int(now - pParent->fsmTimer) ) )
-    {
-        pParent->fsmTimer += 1000;
 
-        // When audio completes, restart it
-        if( GateAudio.IsIdle() )
-        {
-            // DEBUG_V("Audio is idle");
-            GateAudio.PlayCurrentSelection();
-        }
-    }
+    // No Actions
 
     // _ DEBUG_END;
 } // FsmInputGatePlaying::init
 
+// -----------------------------------------------------------------------------
+void FsmInputGatePlaying::Audio_Track_Finished (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    // When audio completes, restart it
+    GateAudio.PlayCurrentSelection();
+
+    // DEBUG_END;
+} // FsmInputGatePlaying::Audio_Track_Finished
+
+// -----------------------------------------------------------------------------
+void FsmInputGatePlaying::Audio_Card_Removed (c_InputGateControl* pParent)
+{
+    // DEBUG_START;
+
+    // nothing left to play
+    FsmInputGateCommon::Audio_Card_Removed(pParent);
+    FsmInputGateIdle_Imp.init(pParent);
+
+    // DEBUG_END;
+} // FsmInputGatePlaying::Audio_Card_Removed
+
 // -----------------------------------------------------------------------------
 void FsmInputGatePlaying::Button_Play_Pressed (c_InputGateControl* pParent)
 {
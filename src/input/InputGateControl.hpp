@@ -41,6 +41,7 @@ void Button_Lights_Pressed ();
 void Button_Play_Pressed ();
 void Button_Skip_Pressed ();
 void Button_Stop_Pressed ();
+void Audio_Event (uint8_t Event);
 
 protected:
 
@@ -85,6 +86,9 @@ virtual void Button_Lights_Pressed (c_InputGateControl* pParent) {}
 virtual void Button_Play_Pressed (c_InputGateControl* pParent) {}
 virtual void Button_Skip_Pressed (c_InputGateControl* pParent) {}
 virtual void Button_Stop_Pressed (c_InputGateControl* pParent) {}
+virtual void Audio_Track_Finished (c_InputGateControl* pParent) {}
+virtual void Audio_Card_Removed (c_InputGateControl* pParent);
+virtual void Audio_Error (c_InputGateControl* pParent);
 
 protected:
 c_InputGateControl* _pParent = nullptr;
@@ -123,6 +127,9 @@ void Button_Open_Pressed (c_InputGateControl* pParent) override;
 // void Button_Play_Pressed (c_InputGateControl * pParent) override;
 // void Button_Skip_Pressed (c_InputGateControl * pParent) override;
 // void Button_Stop_Pressed (c_InputGateControl * pParent) override;
+void Audio_Track_Finished (c_InputGateControl* pParent) override;
+void Audio_Card_Removed (c_InputGateControl* pParent) override;
+void Audio_Error (c_InputGateControl* pParent) override;
 
 }; // FsmInputGateOpening
 
@@ -137,6 +144,7 @@ void Button_Open_Pressed (c_InputGateControl* pParent) override;
 // void Button_Play_Pressed (c_InputGateControl * pParent) override;
 // void Button_Skip_Pressed (c_InputGateControl * pParent) override;
 // void Button_Stop_Pressed (c_InputGateControl * pParent) override;
+void Audio_Track_Finished (c_InputGateControl* pParent) override;
 
 }; // FsmInputGateOpening
 
@@ -151,6 +159,7 @@ void Button_Open_Pressed (c_InputGateControl* pParent) override;
 void Button_Play_Pressed (c_InputGateControl * pParent) override;
 void Button_Skip_Pressed (c_InputGateControl * pParent) override;
 void Button_Stop_Pressed (c_InputGateControl * pParent) override;
+void Audio_Track_Finished (c_InputGateControl* pParent) override;
 
 }; // FsmInputGateOpen
 
@@ -187,6 +196,8 @@ String name () {return( F("Playing") );}
 void Button_Play_Pressed (c_InputGateControl* pParent) override;
 void Button_Skip_Pressed (c_InputGateControl* pParent) override;
 void Button_Stop_Pressed (c_InputGateControl* pParent) override;
+void Audio_Track_Finished (c_InputGateControl* pParent) override;
+void Audio_Card_Removed (c_InputGateControl* pParent) override;
 
 }; // FsmInputGateLights
 
@@ -37,6 +37,7 @@ c_OutputCommon::c_OutputCommon (c_OutputMgr::e_OutputChannelIds _OutputChannelId
     UartId                   = uart;
     OutputType               = outputType;
     pOutputBuffer            = OutputMgr.GetBufferAddress ();
+    pFrameData               = pOutputBuffer;
     FrameStartTimeInMicroSec = 0;
 
     // logcon (String ("UartId:          '") + UartId + "'");
@@ -69,8 +70,11 @@ void c_OutputCommon::GetStatus (JsonObject & jsonStatus)
     // DEBUG_START;
 
     jsonStatus[CN_id]              = OutputChannelId;
-    jsonStatus["framerefreshrate"] = (0 == FrameRefreshTimeInMicroSec)?0 : int(MicroSecondsInASecond / FrameDurationInMicroSec);
+    jsonStatus["framerefreshrate"] = (0 == FrameRefreshTimeInMicroSec)?0 : int(MicroSecondsInASecond / FrameRefreshTimeInMicroSec);
     jsonStatus["FrameCount"]       = FrameCount;
+    jsonStatus["FrameUs"]          = FrameRefreshTimeInMicroSec;
+    jsonStatus["JitterUs"]         = FrameJitterUs;
+    jsonStatus["JitterMaxUs"]      = FrameJitterMaxUs;
 
     // jsonStatus["ActualFrameDurationMicroSec"] = ActualFrameDurationMicroSec;
     // jsonStatus["FrameDurationInMicroSec"]     = FrameDurationInMicroSec;
@@ -95,6 +99,15 @@ void c_OutputCommon::ReportNewFrame ()
     FrameEndTimeInMicroSec     = FrameStartTimeInMicroSec + FrameDurationInMicroSec;
     FrameCount++;
 
+    // jitter only means something between back to back frames. A frame
+    // after an idle period is not late.
+    if (FrameRefreshTimeInMicroSec < (2 * FrameDurationInMicroSec) )
+    {
+        uint32_t Jitter = abs ( int32_t (FrameRefreshTimeInMicroSec - FrameDurationInMicroSec) );
+        FrameJitterMaxUs = max (FrameJitterMaxUs, Jitter);
+        FrameJitterUs    = uint32_t ( int32_t (FrameJitterUs) + ( (int32_t (Jitter) - int32_t (FrameJitterUs) ) / 8) );
+    }
+
     // DEBUG_END;
 }  // ReportNewFrame
 
@@ -70,7 +70,12 @@ virtual void GetStatus (ArduinoJson::JsonObject & jsonStatus);
 void SetOutputBufferAddress (uint8_t* pNewOutputBuffer)
 {
     pOutputBuffer = pNewOutputBuffer;
+    pFrameData    = pNewOutputBuffer;
 }
+void SetFrameDataAddress (uint8_t* pNewFrameData)
+{
+    pFrameData = pNewFrameData;
+}                                                                               ///< Set the address of the frame that Poll() transmits
 virtual void SetOutputBufferSize (uint32_t NewOutputBufferSize)
 {
     OutputBufferSize = NewOutputBufferSize;
@@ -87,6 +92,18 @@ virtual void WriteChannelData (uint32_t StartChannelId,
 virtual void ReadChannelData (uint32_t  StartChannelId,
  uint32_t                               ChannelCount,
  byte*                                  pTargetData);
+virtual void MoveChannelTo (uint32_t ChannelId,
+ uint16_t                            TargetValue,
+ uint32_t                            DurationMs,
+ c_OutputMgr::MotionCurve_t          Curve)
+{
+    uint8_t Value = uint8_t (TargetValue);
+    WriteChannelData (ChannelId, 1, &Value);
+}                                                                               ///< Drivers without motion support jump to the target
+virtual bool IsChannelDataDirect ()
+{
+    return(true);
+}                                                                               ///< false if WriteChannelData / ReadChannelData do more than copy to pOutputBuffer
 virtual bool ValidateGpio (gpio_num_t   ConsoleTxGpio,
  gpio_num_t                             ConsoleRxGpio);
 virtual bool DriverIsSendingIntensityData ()
@@ -97,6 +114,21 @@ virtual uint32_t GetFrameTimeMs ()
 {
     return( 1 + (ActualFrameDurationMicroSec / 1000) );
 }
+void MarkChannelsDirty (uint32_t DirtyMask)
+{
+    DirtyChannels |= DirtyMask;
+}                                                                               ///< one bit per byte of the buffer slice that changed. Consumed by Poll()
+virtual bool HasPendingWork ()
+{
+    return(false);
+}                                                                               ///< true if the driver needs to be polled even though its data has not changed
+inline bool IsFrameDue (uint32_t Now)
+{
+    // allow a frame to go out a little early so that a caller running at
+    // exactly the frame rate does not skip every other frame. Elapsed time
+    // does not care how long the driver has been idle.
+    return( (Now - FrameStartTimeInMicroSec) >= (FrameDurationInMicroSec - (FrameDurationInMicroSec / 8) ) );
+}                                                                               ///< has the frame period passed since the last frame
 protected:
 
 gpio_num_t DataPin                   = gpio_num_t (-1);
@@ -106,9 +138,11 @@ OID_t OutputChannelId                = OID_t::OutputChannelId_End;
 bool HasBeenInitialized              = false;
 uint32_t FrameDurationInMicroSec     = 25000;
 uint32_t ActualFrameDurationMicroSec = 50000;        // Default time for relays is every 50ms
-uint8_t* pOutputBuffer               = nullptr;
+uint8_t* pOutputBuffer               = nullptr;     // written by the input side
+uint8_t* pFrameData                  = nullptr;     // frame being transmitted by Poll()
 uint32_t OutputBufferSize            = 0;
 uint32_t FrameCount                  = 0;
+uint32_t DirtyChannels               = uint32_t (-1);   // see MarkChannelsDirty
 
 void ReportNewFrame ();
 
@@ -136,4 +170,6 @@ uint32_t FrameRefreshTimeInMicroSec = 0;
 uint32_t FrameStartTimeInMicroSec   = 0;
 uint32_t FrameEndTimeInMicroSec     = 0;
 uint32_t FrameTimeDeltaInMicroSec   = 0;
+uint32_t FrameJitterUs              = 0;    // average deviation from the frame period
+uint32_t FrameJitterMaxUs           = 0;
 }; // c_OutputCommon
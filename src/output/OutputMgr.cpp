@@ -34,6 +34,8 @@
 
 #include "InputMgr.hpp"
 
+#include <Wire.h>
+
 #ifndef DEFAULT_RELAY_GPIO
     #define DEFAULT_RELAY_GPIO gpio_num_t::GPIO_NUM_1
 #endif // ndef DEFAULT_RELAY_GPIO
@@ -63,13 +65,10 @@ typedef struct
 } OutputChannelIdToGpioAndPortEntry_t;
 
 // -----------------------------------------------------------------------------
-static const OutputChannelIdToGpioAndPortEntry_t OutputChannelIdToGpioAndPort[] =
+// All of the output channels share the I2C bus
+static const OutputChannelIdToGpioAndPortEntry_t OutputChannelIdToGpioAndPort =
 {
-    {DEFAULT_RELAY_GPIO, uart_port_t (-1), c_OutputMgr::OM_PortType_t::Relay},
-    {DEFAULT_RELAY_GPIO, uart_port_t (-1), c_OutputMgr::OM_PortType_t::Relay},
-    {DEFAULT_RELAY_GPIO, uart_port_t (-1), c_OutputMgr::OM_PortType_t::Relay},
-    {DEFAULT_RELAY_GPIO, uart_port_t (-1), c_OutputMgr::OM_PortType_t::Relay},
-    {DEFAULT_RELAY_GPIO, uart_port_t (-1), c_OutputMgr::OM_PortType_t::Relay},
+    DEFAULT_RELAY_GPIO, uart_port_t (-1), c_OutputMgr::OM_PortType_t::Relay
 };
 
 // -----------------------------------------------------------------------------
@@ -80,8 +79,8 @@ c_OutputMgr::c_OutputMgr ()
 {
     ConfigFileName = String ("/") + String (CN_output_config) + CN_Dotjson;
 
-    // clear the input data buffer
-    memset ( (char*)&OutputBuffer[0], 0, sizeof (OutputBuffer) );
+    // the buffers are sized in Begin once we know how many drivers there are
+    FrameReady = false;
 }  // c_OutputMgr
 
 // -----------------------------------------------------------------------------
@@ -117,7 +116,11 @@ void c_OutputMgr::Begin ()
             break;
         }
 
-        if (0 == OutputChannelId_End)
+        std::vector <uint8_t> Addresses;
+        DetectOutputDevices (Addresses);
+        uint32_t NumDrivers = Addresses.size ();
+
+        if (0 == NumDrivers)
         {
             logcon ( F ("ERROR: No output Channels defined. Rebooting") );
             reboot = true;
@@ -126,6 +129,15 @@ void c_OutputMgr::Begin ()
 
         HasBeenInitialized = true;
 
+        // size everything once. The drivers keep pointers into OutputBuffer
+        OutputChannelDrivers.resize (NumDrivers);
+        OutputBuffer.assign (NumDrivers * OM_CHANNELS_PER_DRIVER, 0);
+        FrameBuffers[0].assign (OutputBuffer.size (), 0);
+        FrameBuffers[1].assign (OutputBuffer.size (), 0);
+        ChannelToDriver.assign (OutputBuffer.size (), uint8_t (OutputChannelId_End) );
+
+        DriverLock = xSemaphoreCreateMutex ();
+
         #ifdef LED_FLASH_GPIO
             pinMode (LED_FLASH_GPIO, OUTPUT);
             digitalWrite (LED_FLASH_GPIO, LED_FLASH_OFF);
@@ -136,6 +148,7 @@ void c_OutputMgr::Begin ()
         for (DriverInfo_t & CurrentOutputChannelDriver : OutputChannelDrivers)
         {
             // DEBUG_V(String("init index: ") + String(index) + " Start");
+            CurrentOutputChannelDriver.I2CAddress = Addresses[index];
             CurrentOutputChannelDriver.DriverId = e_OutputChannelIds (index++);
             InstantiateNewOutputChannel (CurrentOutputChannelDriver, e_OutputType::OutputType_Start);
             // DEBUG_V(String("init index: ") + String(index) + " Done");
@@ -150,12 +163,111 @@ void c_OutputMgr::Begin ()
         // CreateNewConfig ();
 
         // Preset the output memory
-        memset ( (void*)&OutputBuffer[0], 0x00, sizeof (OutputBuffer) );
+        memset ( OutputBuffer.data (), 0x00, OutputBuffer.size () );
+
+        StartOutputTask ();
     } while (false);
 
     // DEBUG_END;
 }  // begin
 
+// -----------------------------------------------------------------------------
+/* Scan the I2C bus for PCA9685 boards.
+ *
+ *   Addresses
+ *       One entry per output channel (driver). The first OM_MIN_NUM_DRIVERS
+ *       addresses are always used so that the existing channel numbering
+ *       is kept when a board is missing. Any other board that is found
+ *       is added after them.
+ */
+void c_OutputMgr::DetectOutputDevices (std::vector <uint8_t> & Addresses)
+{
+    // DEBUG_START;
+
+    Addresses.clear ();
+
+    Wire.begin ( int (DEFAULT_I2C_SDA), int (DEFAULT_I2C_SCL) );
+
+    for (uint8_t Address = OM_I2C_FIRST_ADDRESS; Address <= OM_I2C_LAST_ADDRESS; ++Address)
+    {
+        bool Required = (Address < (OM_I2C_FIRST_ADDRESS + OM_MIN_NUM_DRIVERS) );
+
+        // every board answers the all call address
+        if (OM_I2C_ALLCALL_ADDRESS == Address)
+        {
+            continue;
+        }
+
+        if ( IsPca9685 (Address) )
+        {
+            logcon ( String ( F ("Found PCA9685 at address 0x") ) + String (Address, HEX) );
+            Addresses.push_back (Address);
+        }
+        else if (Required)
+        {
+            // the driver keeps looking for it
+            Addresses.push_back (Address);
+        }
+    }
+
+    // DEBUG_V (String ("NumDrivers: ") + String (Addresses.size ()));
+
+    // DEBUG_END;
+}  // DetectOutputDevices
+
+// -----------------------------------------------------------------------------
+/* Anything can answer in the 0x40 - 0x7E range (an RTC module puts an
+ * EEPROM at 0x57 and a DS3231 at 0x68). Only take it for a PCA9685 if the
+ * registers this firmware never writes hold their PCA9685 values. The
+ * device is only read.
+ */
+bool c_OutputMgr::IsPca9685 (uint8_t Address)
+{
+    // DEBUG_START;
+
+    bool response = false;
+
+    auto ReadRegister = [Address] (uint8_t Register, uint8_t & Value)
+    {
+        Wire.beginTransmission (Address);
+        Wire.write (Register);
+
+        if ( (0 != Wire.endTransmission () ) || (1 != Wire.requestFrom ( Address, uint8_t (1) ) ) )
+        {
+            return(false);
+        }
+
+        Value = Wire.read ();
+        return(true);
+    };
+
+    do  // once
+    {
+        uint8_t Value = 0;
+
+        if ( !ReadRegister (OM_PCA9685_SUBADR1, Value) || (0xE2 != Value) )
+        {
+            break;
+        }
+
+        if ( !ReadRegister (OM_PCA9685_ALLCALLADR, Value) || (0xE0 != Value) )
+        {
+            break;
+        }
+
+        // the chip does not accept a prescale below 3
+        if ( !ReadRegister (OM_PCA9685_PRESCALE, Value) || (3 > Value) )
+        {
+            break;
+        }
+
+        response = true;
+    } while (false);
+
+    // DEBUG_END;
+    return(response);
+}  // IsPca9685
+
 // -----------------------------------------------------------------------------
 void c_OutputMgr::CreateJsonConfig (JsonObject & jsonConfig)
 {
@@ -268,14 +380,15 @@ void c_OutputMgr::CreateNewConfig ()
     BuildingNewConfig = true;
 
     // create a place to save the config
-    DynamicJsonDocument JsonConfigDoc (OM_MAX_CONFIG_SIZE);
+    DynamicJsonDocument JsonConfigDoc ( OM_CONFIG_BASE_SIZE + ( OutputBuffer.size () * OM_CONFIG_SIZE_PER_CHANNEL ) );
     // DEBUG_V ();
 
     JsonObject JsonConfig = JsonConfigDoc.createNestedObject (CN_output_config);
     // DEBUG_V ();
 
     JsonConfig[CN_cfgver]      = CurrentConfigVersion;
-    JsonConfig[CN_MaxChannels] = sizeof (OutputBuffer);
+    JsonConfig[CN_MaxChannels] = OutputBuffer.size ();
+    JsonConfig["OutputTask"]   = UseOutputTask;
 
     // Collect the all ports disabled config first
     CreateJsonConfig (JsonConfig);
@@ -364,6 +477,8 @@ void c_OutputMgr::GetStatus (JsonObject & jsonStatus)
         // jsonStatus["PollCount"] = PollCount;
     #endif // defined(ARDUINO_ARCH_ESP32)
 
+    jsonStatus["OutputTask"] = (nullptr != OutputTaskHandle);
+
     JsonArray OutputStatus = jsonStatus.createNestedArray (CN_output);
     for (auto & CurrentOutput : OutputChannelDrivers)
     {
@@ -426,9 +541,9 @@ void c_OutputMgr::InstantiateNewOutputChannel (DriverInfo_t & CurrentOutputChann
         // DEBUG_V ();
 
         // get the new data and UART info
-        CurrentOutputChannelDriver.GpioPin  = OutputChannelIdToGpioAndPort[CurrentOutputChannelDriver.DriverId].GpioPin;
-        CurrentOutputChannelDriver.PortType = OutputChannelIdToGpioAndPort[CurrentOutputChannelDriver.DriverId].PortType;
-        CurrentOutputChannelDriver.PortId   = OutputChannelIdToGpioAndPort[CurrentOutputChannelDriver.DriverId].PortId;
+        CurrentOutputChannelDriver.GpioPin  = OutputChannelIdToGpioAndPort.GpioPin;
+        CurrentOutputChannelDriver.PortType = OutputChannelIdToGpioAndPort.PortType;
+        CurrentOutputChannelDriver.PortId   = OutputChannelIdToGpioAndPort.PortId;
 
         // DEBUG_V (String("DriverId: ") + String(CurrentOutputChannelDriver.DriverId));
         // DEBUG_V (String(" GpioPin: ") + String(CurrentOutputChannelDriver.PortId));
@@ -459,7 +574,8 @@ void c_OutputMgr::InstantiateNewOutputChannel (DriverInfo_t & CurrentOutputChann
                     CurrentOutputChannelDriver.DriverId,
                     CurrentOutputChannelDriver.GpioPin,
                     CurrentOutputChannelDriver.PortId,
-                    OutputType_Servo_PCA9685);
+                    OutputType_Servo_PCA9685,
+                    CurrentOutputChannelDriver.I2CAddress);
                 // DEBUG_V ();
                 break;
             }
@@ -491,7 +607,8 @@ void c_OutputMgr::InstantiateNewOutputChannel (DriverInfo_t & CurrentOutputChann
                 CurrentOutputChannelDriver.DriverId,
                 CurrentOutputChannelDriver.GpioPin,
                 CurrentOutputChannelDriver.PortId,
-                OutputType_Servo_PCA9685);
+                OutputType_Servo_PCA9685,
+                CurrentOutputChannelDriver.I2CAddress);
             // DEBUG_V ();
             break;
         }
@@ -608,6 +725,8 @@ bool c_OutputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
             // break;
         }
 
+        setFromJSON (UseOutputTask, OutputChannelMgrData, "OutputTask");
+
         // do we have a channel configuration array?
         if ( false == OutputChannelMgrData.containsKey (CN_channels) )
         {
@@ -625,9 +744,10 @@ bool c_OutputMgr::ProcessJsonConfig (JsonObject & jsonConfig)
             // get access to the channel config
             if ( false == OutputChannelArray.containsKey ( String (CurrentOutputChannelDriver.DriverId).c_str () ) )
             {
-                // if not, flag an error and stop processing
+                // if not, flag an error and keep the defaults for this channel.
+                // Happens when a board is added to the bus.
                 logcon (String (MN_16) + CurrentOutputChannelDriver.DriverId + MN_18);
-                break;
+                continue;
             }
 
             JsonObject OutputChannelConfig = OutputChannelArray[String (CurrentOutputChannelDriver.DriverId).c_str ()];
@@ -772,22 +892,192 @@ void c_OutputMgr::Poll ()
     if (true == ConfigLoadNeeded)
     {
         ConfigLoadNeeded = false;
+
+        // the output task must not poll a driver that is being replaced
+        xSemaphoreTake (DriverLock, portMAX_DELAY);
         LoadConfig ();
+        StartOutputTask ();
+        xSemaphoreGive (DriverLock);
     }  // done need to save the current config
 
-    if (false == IsOutputPaused)
+    if (UseOutputTask)
+    {
+        PublishFrame ();
+    }
+    else if (false == IsOutputPaused)
     {
-        // //DEBUG_V();
         for (DriverInfo_t & OutputChannel : OutputChannelDrivers)
         {
-            // //DEBUG_V("Start a new channel");
-            OutputChannel.pOutputChannelDriver->Poll ();
+            OutputChannel.OutputDirty |= OutputChannel.InputDirty;
+            OutputChannel.InputDirty   = 0;
         }
+
+        PollDrivers ( OutputBuffer.data () );
     }
 
     // //DEBUG_END;
 }  // Poll
 
+// -----------------------------------------------------------------------------
+void c_OutputMgr::PollDrivers (uint8_t* pFrameData)
+{
+    // //DEBUG_START;
+
+    uint32_t Now = micros ();
+
+    for (DriverInfo_t & OutputChannel : OutputChannelDrivers)
+    {
+        c_OutputCommon* pDriver = OutputChannel.pOutputChannelDriver;
+
+        // nothing new to send: no bus traffic at all
+        if ( (0 == OutputChannel.OutputDirty) && (false == pDriver->HasPendingWork () ) )
+        {
+            continue;
+        }
+
+        // hold the data until the driver frame period has passed
+        if ( false == pDriver->IsFrameDue (Now) )
+        {
+            continue;
+        }
+
+        // //DEBUG_V("Start a new channel");
+        pDriver->MarkChannelsDirty (OutputChannel.OutputDirty);
+        OutputChannel.OutputDirty = 0;
+        pDriver->SetFrameDataAddress (&pFrameData[OutputChannel.OutputBufferStartingOffset]);
+        pDriver->Poll ();
+    }
+
+    // //DEBUG_END;
+}  // PollDrivers
+
+// -----------------------------------------------------------------------------
+///< Hand the current frame to the output task without waiting for it
+void c_OutputMgr::PublishFrame ()
+{
+    // //DEBUG_START;
+
+    // if the task has not picked up the last frame yet, this frame is
+    // published on a later pass. OutputBuffer always holds the newest data.
+    if (false == FrameReady.load (std::memory_order_acquire) )
+    {
+        bool FrameIsDirty = false;
+
+        for (DriverInfo_t & OutputChannel : OutputChannelDrivers)
+        {
+            OutputChannel.PublishedDirty = OutputChannel.InputDirty;
+            OutputChannel.InputDirty     = 0;
+            FrameIsDirty                |= (0 != OutputChannel.PublishedDirty);
+        }
+
+        // an unchanged frame is not worth the copy
+        if (FrameIsDirty)
+        {
+            memcpy (FrameBuffers[WriteFrame].data (), OutputBuffer.data (), UsedBufferSize);
+            FrameReady.store (true, std::memory_order_release);
+        }
+    }
+
+    // //DEBUG_END;
+}  // PublishFrame
+
+// -----------------------------------------------------------------------------
+///< Called with the DriverLock held
+void c_OutputMgr::StartOutputTask ()
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        if ( (false == UseOutputTask) || (nullptr != OutputTaskHandle) )
+        {
+            break;
+        }
+
+        // start from the current outputs so nothing moves when the task takes over
+        FrameBuffers[0] = OutputBuffer;
+        FrameBuffers[1] = OutputBuffer;
+        WriteFrame = 0;
+        ReadFrame  = 1;
+        FrameReady = false;
+
+        if ( pdPASS != xTaskCreatePinnedToCore (OutputTask,
+                                                OM_OUTPUT_TASK_NAME,
+                                                OM_OUTPUT_TASK_STACK_SIZE,
+                                                this,
+                                                OM_OUTPUT_TASK_PRIORITY,
+                                                &OutputTaskHandle,
+                                                OM_OUTPUT_TASK_CORE) )
+        {
+            logcon ( F ("ERROR: Could not start the output task. Polling outputs from loop().") );
+            OutputTaskHandle = nullptr;
+            UseOutputTask    = false;
+        }
+    } while (false);
+
+    // DEBUG_END;
+}  // StartOutputTask
+
+// -----------------------------------------------------------------------------
+void c_OutputMgr::OutputTask (void* pvParameters)
+{
+    // DEBUG_START;
+
+    c_OutputMgr*    pOutputMgr   = reinterpret_cast <c_OutputMgr*>(pvParameters);
+    TickType_t      LastWakeTime = xTaskGetTickCount ();
+
+    while ( pOutputMgr->RunOutputTask () )
+    {
+        vTaskDelayUntil ( &LastWakeTime, pdMS_TO_TICKS (pOutputMgr->OutputTaskPeriodMs) );
+    }
+
+    // DEBUG_END;
+    vTaskDelete (nullptr);
+}  // OutputTask
+
+// -----------------------------------------------------------------------------
+///< Render one frame from the output task. Returns false when the task should exit.
+bool c_OutputMgr::RunOutputTask ()
+{
+    // DEBUG_START;
+
+    xSemaphoreTake (DriverLock, portMAX_DELAY);
+
+    bool Response = UseOutputTask;
+
+    if (false == Response)
+    {
+        // loop() has taken over polling the drivers
+        OutputTaskHandle = nullptr;
+    }
+    else
+    {
+        // pick up the most recently published frame
+        if ( FrameReady.load (std::memory_order_acquire) )
+        {
+            ReadFrame  = WriteFrame;
+            WriteFrame = ReadFrame ^ 1;
+
+            for (DriverInfo_t & OutputChannel : OutputChannelDrivers)
+            {
+                OutputChannel.OutputDirty |= OutputChannel.PublishedDirty;
+            }
+
+            FrameReady.store (false, std::memory_order_release);
+        }
+
+        if (false == IsOutputPaused)
+        {
+            PollDrivers ( FrameBuffers[ReadFrame].data () );
+        }
+    }
+
+    xSemaphoreGive (DriverLock);
+
+    // DEBUG_END;
+    return(Response);
+}  // RunOutputTask
+
 // -----------------------------------------------------------------------------
 void c_OutputMgr::UpdateDisplayBufferReferences (void)
 {
@@ -804,8 +1094,13 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
      */
     uint32_t    OutputBufferOffset  = 0;    // offset into the raw data in the output buffer
     uint32_t    OutputChannelOffset = 0;    // Virtual channel offset to the output buffer.
+    uint32_t    FramePeriodMs       = uint32_t (-1);
+    uint8_t     DriverIndex         = 0;
+
+    ChannelsAreIdentityMapped = true;
+    std::fill (ChannelToDriver.begin (), ChannelToDriver.end (), uint8_t (OutputChannelId_End) );
 
-    // DEBUG_V (String ("        BufferSize: ") + String (sizeof(OutputBuffer)));
+    // DEBUG_V (String ("        BufferSize: ") + String (OutputBuffer.size ()));
     // DEBUG_V (String ("OutputBufferOffset: ") + String (OutputBufferOffset));
 
     for (auto & OutputChannel : OutputChannelDrivers)
@@ -822,7 +1117,7 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
         uint32_t    OutputBufferDataBytesNeeded        = OutputChannel.pOutputChannelDriver->GetNumOutputBufferBytesNeeded ();
         uint32_t    VirtualOutputBufferDataBytesNeeded = OutputChannel.pOutputChannelDriver->GetNumOutputBufferChannelsServiced ();
 
-        uint32_t    AvailableChannels = sizeof (OutputBuffer) - OutputBufferOffset;
+        uint32_t    AvailableChannels = OutputBuffer.size () - OutputBufferOffset;
 
         if (AvailableChannels < OutputBufferDataBytesNeeded)
         {
@@ -845,13 +1140,35 @@ void c_OutputMgr::UpdateDisplayBufferReferences (void)
         OutputChannel.OutputChannelSize      = VirtualOutputBufferDataBytesNeeded;
         OutputChannel.OutputChannelEndOffset = OutputChannelOffset;
 
+        // the output task runs at the rate of the fastest driver
+        FramePeriodMs = min ( FramePeriodMs, OutputChannel.pOutputChannelDriver->GetFrameTimeMs () );
+
+        // can channel writes for this driver go straight into the output buffer?
+        if ( (OutputChannel.OutputChannelStartingOffset != OutputChannel.OutputBufferStartingOffset) ||
+             (OutputChannel.OutputChannelSize != OutputChannel.OutputBufferDataSize) ||
+             (false == OutputChannel.pOutputChannelDriver->IsChannelDataDirect () ) )
+        {
+            ChannelsAreIdentityMapped = false;
+        }
+
+        for (uint32_t ChannelId = OutputChannel.OutputChannelStartingOffset;
+             ChannelId < min ( OutputChannel.OutputChannelEndOffset, uint32_t ( ChannelToDriver.size () ) );
+             ++ChannelId)
+        {
+            ChannelToDriver[ChannelId] = DriverIndex;
+        }
+
+        ++DriverIndex;
+
         // DEBUG_V (String("OutputChannel.GetBufferUsedSize: ") + String(OutputChannel.pOutputChannelDriver->GetBufferUsedSize()));
         // DEBUG_V (String ("OutputBufferOffset: ") + String(OutputBufferOffset));
     }
 
     // DEBUG_V (String ("   TotalBufferSize: ") + String (OutputBufferOffset));
     UsedBufferSize = OutputBufferOffset;
-    // DEBUG_V (String ("       OutputBuffer: 0x") + String (uint32_t (OutputBuffer), HEX));
+    MarkAllDirty ();
+    OutputTaskPeriodMs = ( uint32_t (-1) == FramePeriodMs ) ? OutputTaskPeriodMs : FramePeriodMs;
+    // DEBUG_V (String ("       OutputBuffer: 0x") + String (uint32_t (OutputBuffer.data ()), HEX));
     // DEBUG_V (String ("     UsedBufferSize: ") + String (uint32_t (UsedBufferSize)));
     InputMgr.SetBufferInfo (OutputChannelOffset);
 
@@ -888,28 +1205,31 @@ void c_OutputMgr::WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCou
             break;
         }
 
-        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
-        uint32_t EndChannelId = StartChannelId + ChannelCount;
-        // Serial.print('1');
-        for (auto & currentOutputChannelDriver : OutputChannelDrivers)
+        if (ChannelsAreIdentityMapped)
         {
-            // Serial.print('2');
-            // does this output handle this block of data?
-            if (StartChannelId < currentOutputChannelDriver.OutputChannelStartingOffset)
+            // the common case. No driver is involved. Only flag what really changed
+            for (uint32_t ChannelId = StartChannelId; ChannelId < (StartChannelId + ChannelCount); ++ChannelId, ++pSourceData)
             {
-                // we have gone beyond where we can put this data.
-                // Serial.print('3');
-                break;
+                if (OutputBuffer[ChannelId] != *pSourceData)
+                {
+                    OutputBuffer[ChannelId] = *pSourceData;
+                    MarkDirty (ChannelId, 1);
+                }
             }
 
-            if (StartChannelId > currentOutputChannelDriver.OutputChannelEndOffset)
-            {
-                // move to the next driver
-                // Serial.print('4');
-                continue;
-            }
+            break;
+        }
 
-            // Serial.print('5');
+        MarkDirty (StartChannelId, ChannelCount);
+
+        uint32_t EndChannelId = StartChannelId + ChannelCount;
+
+        // start at the driver that owns the first channel
+        for (uint32_t DriverIndex = ChannelToDriver[StartChannelId];
+             (DriverIndex < OutputChannelDrivers.size ()) && (StartChannelId < EndChannelId);
+             ++DriverIndex)
+        {
+            DriverInfo_t & currentOutputChannelDriver = OutputChannelDrivers[DriverIndex];
 
             uint32_t    lastChannelToSet       = min (EndChannelId, currentOutputChannelDriver.OutputChannelEndOffset);
             uint32_t    ChannelsToSet          = lastChannelToSet - StartChannelId;
@@ -926,13 +1246,88 @@ void c_OutputMgr::WriteChannelData (uint32_t StartChannelId, uint32_t ChannelCou
 
             StartChannelId += ChannelsToSet;
             pSourceData    += ChannelsToSet;
-            // memcpy(&OutputBuffer[StartChannelId], pSourceData, ChannelCount);
         }
     } while (false);
 
     // DEBUG_END;
 }  // WriteChannelData
 
+// -----------------------------------------------------------------------------
+///< Flag the drivers that own a range of channels as needing a new frame
+void c_OutputMgr::MarkDirty (uint32_t StartChannelId, uint32_t ChannelCount)
+{
+    // DEBUG_START;
+
+    uint32_t    EndChannelId = StartChannelId + ChannelCount;
+    uint32_t    FirstDriver  = ChannelToDriver[StartChannelId];
+    uint32_t    LastDriver   = ChannelToDriver[EndChannelId - 1];
+
+    for (uint32_t DriverIndex = FirstDriver;
+         (DriverIndex <= LastDriver) && ( DriverIndex < OutputChannelDrivers.size () );
+         ++DriverIndex)
+    {
+        DriverInfo_t &  OutputChannel = OutputChannelDrivers[DriverIndex];
+        uint32_t        FirstBit      = max (StartChannelId, OutputChannel.OutputChannelStartingOffset) - OutputChannel.OutputChannelStartingOffset;
+        uint32_t        EndBit        = min (EndChannelId, OutputChannel.OutputChannelEndOffset) - OutputChannel.OutputChannelStartingOffset;
+
+        if (EndBit >= 32)
+        {
+            EndBit = 32;
+        }
+
+        if (FirstBit < EndBit)
+        {
+            uint32_t NumBits = EndBit - FirstBit;
+            OutputChannel.InputDirty |= ( (32 == NumBits) ? OM_DIRTY_ALL : ( (uint32_t (1) << NumBits) - 1) ) << FirstBit;
+        }
+    }
+
+    // DEBUG_END;
+}  // MarkDirty
+
+// -----------------------------------------------------------------------------
+void c_OutputMgr::MarkAllDirty ()
+{
+    // DEBUG_START;
+
+    for (DriverInfo_t & OutputChannel : OutputChannelDrivers)
+    {
+        OutputChannel.InputDirty = OM_DIRTY_ALL;
+    }
+
+    // DEBUG_END;
+}  // MarkAllDirty
+
+// -----------------------------------------------------------------------------
+void c_OutputMgr::MoveChannelTo (uint32_t ChannelId, uint16_t TargetValue, uint32_t DurationMs, MotionCurve_t Curve)
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        if ( ChannelId >= ChannelToDriver.size () )
+        {
+            // DEBUG_V (String("ERROR: Invalid ChannelId: ") + String(ChannelId));
+            break;
+        }
+
+        uint32_t DriverIndex = ChannelToDriver[ChannelId];
+
+        if ( DriverIndex >= OutputChannelDrivers.size () )
+        {
+            break;
+        }
+
+        // the driver also stores the target in the output buffer
+        MarkDirty (ChannelId, 1);
+
+        DriverInfo_t & OutputChannel = OutputChannelDrivers[DriverIndex];
+        OutputChannel.pOutputChannelDriver->MoveChannelTo (ChannelId - OutputChannel.OutputChannelStartingOffset, TargetValue, DurationMs, Curve);
+    } while (false);
+
+    // DEBUG_END;
+}  // MoveChannelTo
+
 // -----------------------------------------------------------------------------
 void c_OutputMgr::ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCount, byte* pTargetData)
 {
@@ -949,40 +1344,34 @@ void c_OutputMgr::ReadChannelData (uint32_t StartChannelId, uint32_t ChannelCoun
             break;
         }
 
-        // DEBUG_V (String("&OutputBuffer[StartChannelId]: 0x") + String(uint(&OutputBuffer[StartChannelId]), HEX));
-        uint32_t EndChannelId = StartChannelId + ChannelCount;
-        // Serial.print('1');
-        for (auto & currentOutputChannelDriver : OutputChannelDrivers)
+        if (ChannelsAreIdentityMapped)
         {
-            // Serial.print('2');
-            // does this output handle this block of data?
-            if (StartChannelId < currentOutputChannelDriver.OutputChannelStartingOffset)
-            {
-                // we have gone beyond where we can put this data.
-                // Serial.print('3');
-                break;
-            }
+            // the common case. No driver is involved
+            memcpy (pTargetData, &OutputBuffer[StartChannelId], ChannelCount);
+            break;
+        }
 
-            if (StartChannelId > currentOutputChannelDriver.OutputChannelEndOffset)
-            {
-                // move to the next driver
-                // Serial.print('4');
-                continue;
-            }
+        uint32_t EndChannelId = StartChannelId + ChannelCount;
 
-            // Serial.print('5');
+        // start at the driver that owns the first channel
+        for (uint32_t DriverIndex = ChannelToDriver[StartChannelId];
+             (DriverIndex < OutputChannelDrivers.size ()) && (StartChannelId < EndChannelId);
+             ++DriverIndex)
+        {
+            DriverInfo_t & currentOutputChannelDriver = OutputChannelDrivers[DriverIndex];
 
             uint32_t    lastChannelToSet       = min (EndChannelId, currentOutputChannelDriver.OutputChannelEndOffset);
             uint32_t    ChannelsToSet          = lastChannelToSet - StartChannelId;
             uint32_t    RelativeStartChannelId = StartChannelId - currentOutputChannelDriver.OutputChannelStartingOffset;
+
             // DEBUG_V (String("               StartChannelId: 0x") + String(StartChannelId, HEX));
             // DEBUG_V (String("                 EndChannelId: 0x") + String(EndChannelId, HEX));
             // DEBUG_V (String("             lastChannelToSet: 0x") + String(lastChannelToSet, HEX));
             // DEBUG_V (String("                ChannelsToSet: 0x") + String(ChannelsToSet, HEX));
             currentOutputChannelDriver.pOutputChannelDriver->ReadChannelData (RelativeStartChannelId, ChannelsToSet, pTargetData);
+
             StartChannelId += ChannelsToSet;
             pTargetData    += ChannelsToSet;
-            // memcpy(&OutputBuffer[StartChannelId], pTargetData, ChannelCount);
         }
     } while (false);
 
@@ -994,13 +1383,34 @@ void c_OutputMgr::ClearBuffer ()
 {
     // DEBUG_START;
 
-    for (auto & currentOutputChannelDriver : OutputChannelDrivers)
+    do  // once
     {
-        if (nullptr != currentOutputChannelDriver.pOutputChannelDriver)
+        if (ChannelsAreIdentityMapped)
         {
-            currentOutputChannelDriver.pOutputChannelDriver->ClearBuffer ();
+            // the blank timer calls this over and over. Only flag the
+            // channels that were not already clear.
+            for (uint32_t ChannelId = 0; ChannelId < UsedBufferSize; ++ChannelId)
+            {
+                if (0 != OutputBuffer[ChannelId])
+                {
+                    OutputBuffer[ChannelId] = 0;
+                    MarkDirty (ChannelId, 1);
+                }
+            }
+
+            break;
         }
-    }
+
+        for (auto & currentOutputChannelDriver : OutputChannelDrivers)
+        {
+            if (nullptr != currentOutputChannelDriver.pOutputChannelDriver)
+            {
+                currentOutputChannelDriver.pOutputChannelDriver->ClearBuffer ();
+            }
+        }
+
+        MarkAllDirty ();
+    } while (false);
 
     // DEBUG_END;
 }  // ClearBuffer
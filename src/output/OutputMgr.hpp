@@ -27,6 +27,12 @@
 #include "memdebug.h"
 #include "FileMgr.hpp"
 
+#include <atomic>
+#include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
 class c_OutputCommon;  ///< forward declaration to the pure virtual output class that will be defined later.
 
 #ifdef UART_LAST
@@ -51,12 +57,12 @@ void SetConfig         (ArduinoJson::JsonDocument & NewConfig);             ///<
 void GetStatus         (JsonObject & jsonStatus);
 void GetPortCounts     (uint16_t & PixelCount, uint16_t & SerialCount)
 {
-    PixelCount = uint16_t (OutputChannelId_End);
+    PixelCount = uint16_t ( OutputChannelDrivers.size () );
     SerialCount = uint16_t (NUM_UARTS);
 }
 uint8_t* GetBufferAddress  ()
 {
-    return(OutputBuffer);
+    return( OutputBuffer.data () );
 }                                                                                                               ///< Get the address of the buffer into which the E1.31 handler will stuff data
 uint32_t GetBufferUsedSize ()
 {
@@ -65,7 +71,7 @@ uint32_t GetBufferUsedSize ()
                                                                                                                 ///<    stuff data
 uint32_t GetBufferSize     ()
 {
-    return( sizeof (OutputBuffer) );
+    return( OutputBuffer.size () );
 }                                                                 ///< Get the size (in intensities) of the buffer into which the E1.31 handler will
                                                                   ///<    stuff data
 void DeleteConfig      ()
@@ -85,13 +91,30 @@ void ReadChannelData   (uint32_t    StartChannelId,
  uint8_t*                           pTargetData);
 void ClearBuffer       ();
 
-// handles to determine which output channel we are dealing with
+// Shape of a timed move from the current value of a channel to a target
+enum MotionCurve_t
+{
+    MotionCurveLinear = 0,
+    MotionCurveEaseIn,
+    MotionCurveEaseOut,
+    MotionCurveSCurve,
+};
+
+void MoveChannelTo     (uint32_t    ChannelId,
+ uint16_t                           TargetValue,
+ uint32_t                           DurationMs,
+ MotionCurve_t                      Curve = MotionCurveLinear);     ///< Move a channel to TargetValue over DurationMs. Evaluated by the driver at its frame rate.
+
+// handles to determine which output channel we are dealing with.
+// Channels 0 and 1 are the PCA9685 boards at I2C addresses 0x40 and 0x41.
+// Every other board found on the bus at boot gets the next channel, in
+// address order (see DetectOutputDevices).
 enum e_OutputChannelIds
 {
     OutputChannelId_Relay_1,
     OutputChannelId_Relay_2,
 
-    OutputChannelId_End,      // must be last in the list
+    OutputChannelId_End = 0xff,   // invalid id
     OutputChannelId_Start = 0
 };
 
@@ -105,8 +128,22 @@ enum e_OutputType
     OutputType_Start = OutputType_Servo_PCA9685,
 };
 
-    #define OM_MAX_NUM_CHANNELS (16 * 2)
-    #define OM_MAX_CONFIG_SIZE  ( (uint32_t)(20 * 1024) )
+    #define OM_CHANNELS_PER_DRIVER      16
+    #define OM_MIN_NUM_DRIVERS          2
+    #define OM_DIRTY_ALL                uint32_t (-1)
+    #define OM_I2C_FIRST_ADDRESS        0x40
+    #define OM_I2C_LAST_ADDRESS         0x7E
+    #define OM_I2C_ALLCALL_ADDRESS      0x70
+    #define OM_CONFIG_BASE_SIZE         ( (uint32_t)(4 * 1024) )
+    #define OM_CONFIG_SIZE_PER_CHANNEL  ( (uint32_t)(512) )
+    #define OM_PCA9685_SUBADR1          0x02
+    #define OM_PCA9685_ALLCALLADR       0x05
+    #define OM_PCA9685_PRESCALE         0xFE
+
+    #define OM_OUTPUT_TASK_NAME         "OutputTask"
+    #define OM_OUTPUT_TASK_STACK_SIZE   4096
+    #define OM_OUTPUT_TASK_PRIORITY     2
+    #define OM_OUTPUT_TASK_CORE         0
 
 enum OM_PortType_t
 {
@@ -132,11 +169,18 @@ struct DriverInfo_t
     OM_PortType_t PortType             = OM_PortType_t::Undefined;
     uart_port_t PortId               = uart_port_t (-1);
     e_OutputChannelIds DriverId             = e_OutputChannelIds (-1);
+    uint8_t I2CAddress                   = OM_I2C_FIRST_ADDRESS;
     c_OutputCommon* pOutputChannelDriver = nullptr;
+
+    // One bit per byte of the driver slice of OutputBuffer that changed
+    // since the driver last sent a frame.
+    uint32_t InputDirty                  = OM_DIRTY_ALL;    // written by loop()
+    uint32_t PublishedDirty              = 0;               // travels with FrameBuffers[WriteFrame]
+    uint32_t OutputDirty                 = OM_DIRTY_ALL;    // owned by whoever polls the driver
 };
 
 // pointer(s) to the current active output drivers
-DriverInfo_t OutputChannelDrivers[OutputChannelId_End];
+std::vector <DriverInfo_t> OutputChannelDrivers;
 
 // configuration parameter names for the channel manager within the config file
 
@@ -145,6 +189,32 @@ bool ConfigLoadNeeded   = false;
 bool IsOutputPaused     = false;
 bool BuildingNewConfig  = false;
 
+// Optional output task. When enabled the drivers are polled from a pinned
+// FreeRTOS task so that the I2C transfers do not block loop().
+bool UseOutputTask                  = false;
+TaskHandle_t OutputTaskHandle       = nullptr;
+SemaphoreHandle_t DriverLock        = nullptr;          // held while polling or reconfiguring the drivers
+uint32_t OutputTaskPeriodMs         = 20;
+
+// Frames handed from loop() to the output task. loop() only fills
+// FrameBuffers[WriteFrame] while FrameReady is false and the task only
+// swaps the indexes while it is true so neither side ever waits.
+std::vector <uint8_t> FrameBuffers[2];
+uint8_t WriteFrame                  = 0;
+uint8_t ReadFrame                   = 1;
+std::atomic <bool> FrameReady;
+
+static void OutputTask (void* pvParameters);
+bool RunOutputTask ();
+void StartOutputTask ();
+void PublishFrame ();
+void PollDrivers (uint8_t* pFrameData);
+void MarkDirty (uint32_t    StartChannelId,
+ uint32_t                   ChannelCount);
+void MarkAllDirty ();
+void DetectOutputDevices (std::vector <uint8_t> & Addresses);
+static bool IsPca9685 (uint8_t Address);
+
 bool ProcessJsonConfig (JsonObject & jsonConfig);
 void CreateJsonConfig  (JsonObject & jsonConfig);
 void UpdateDisplayBufferReferences (void);
@@ -155,8 +225,12 @@ void CreateNewConfig ();
 
 String ConfigFileName;
 
-uint8_t OutputBuffer[OM_MAX_NUM_CHANNELS];
+std::vector <uint8_t> OutputBuffer;                     // OM_CHANNELS_PER_DRIVER per driver. Sized in Begin
 uint32_t UsedBufferSize      = 0;
+
+// Channel routing. Built by UpdateDisplayBufferReferences
+bool ChannelsAreIdentityMapped = false;                 // channel N is OutputBuffer[N] for every driver
+std::vector <uint8_t> ChannelToDriver;                  // index into OutputChannelDrivers for each virtual channel
 gpio_num_t ConsoleTxGpio       = gpio_num_t::GPIO_NUM_1;
 gpio_num_t ConsoleRxGpio       = gpio_num_t::GPIO_NUM_3;
 bool ConsoleUartIsActive = true;
@@ -26,12 +26,13 @@
 c_OutputServoPCA9685::c_OutputServoPCA9685 (c_OutputMgr::e_OutputChannelIds OutputChannelId,
  gpio_num_t                                                                 outputGpio,
  uart_port_t                                                                uart,
- c_OutputMgr::e_OutputType                                                  outputType) :
+ c_OutputMgr::e_OutputType                                                  outputType,
+ uint8_t                                                                    I2CAddress) :
     c_OutputCommon (OutputChannelId, outputGpio, uart, outputType)
 {
     // DEBUG_START;
 
-    I2C_Address = PCA9685_I2C_ADDRESS + OutputChannelId;
+    I2C_Address = I2CAddress;
 
     uint32_t id = 0;
     for (ServoPCA9685Channel_t & currentServoPCA9685Channel : OutputList)
@@ -47,6 +48,12 @@ c_OutputServoPCA9685::c_OutputServoPCA9685 (c_OutputMgr::e_OutputChannelIds Outp
         currentServoPCA9685Channel.HomeValue     = 0;
     }
 
+    // matches the power on state of the device (full off)
+    for (uint16_t & currentPwmTicks : PwmTicks)
+    {
+        currentPwmTicks = SERVO_PCA9685_FULL_OFF;
+    }
+
     // DEBUG_END;
 }  // c_OutputServoPCA9685
 
@@ -76,29 +83,26 @@ void c_OutputServoPCA9685::Begin ()
             break;
         }
 
+        // the all call address would drive every board on the bus
+        if (OM_I2C_ALLCALL_ADDRESS == I2C_Address)
+        {
+            break;
+        }
+
         Wire.begin( int (DEFAULT_I2C_SDA), int (DEFAULT_I2C_SCL) );
+        ProbeEnabled   = true;
+        LastRecoveryMs = millis ();
 
         // DEBUG_V(String("I2C_Address: ") + String(I2C_Address));
-        Wire.beginTransmission(I2C_Address);
-        int error = Wire.endTransmission();
-
-        if (error != 0)
+        if (!InitDevice ())
         {
-            // DEBUG_V(String("I2C error: ") + String(error));
+            // Poll keeps looking for it
             logcon( String( F("ERROR: Could not find PCA device at address ") ) + String(I2C_Address) );
             break;
         }
 
-        FoundDevice = true;
-
-        // DEBUG_V("Allocate PWM");
-        pwm = new Adafruit_PWMServoDriver (I2C_Address, Wire);
-
         SetOutputBufferSize (Num_Channels);
 
-        pwm->begin ();
-        pwm->setPWMFreq (UpdateFrequency);
-
         validate ();
 
         HasBeenInitialized = true;
@@ -144,7 +148,7 @@ bool c_OutputServoPCA9685::validate ()
     {
         logcon (CN_stars + String (MN_02) + CN_stars);
 
-        for (int ChannelIndex = OM_SERVO_PCA9685_CHANNEL_LIMIT - 1; ChannelIndex > Num_Channels; ChannelIndex--)
+        for (int ChannelIndex = OM_SERVO_PCA9685_CHANNEL_LIMIT - 1; ChannelIndex >= Num_Channels; ChannelIndex--)
         {
             logcon (CN_stars + String (MN_03) + String (ChannelIndex + 1) + "' " + CN_stars);
             OutputList[ChannelIndex].Enabled = false;
@@ -154,6 +158,43 @@ bool c_OutputServoPCA9685::validate ()
     }
 
     SetOutputBufferSize (Num_Channels);
+    BuildTickTables ();
+
+    // one frame per servo pulse
+    FrameDurationInMicroSec = uint32_t (float(MicroSecondsInASecond) / UpdateFrequency);
+
+    // map the dirty bytes of the buffer slice onto the channels that read them
+    EnabledChannels  = 0;
+    Has16BitChannels = false;
+    DitherChannels   = 0;
+
+    for (ServoPCA9685Channel_t & currentServoPCA9685 : OutputList)
+    {
+        uint8_t ChannelId = currentServoPCA9685.Id;
+
+        if (currentServoPCA9685.Enabled)
+        {
+            EnabledChannels |= (1 << ChannelId);
+        }
+
+        currentServoPCA9685.DirtyMask = uint32_t (1) << ChannelId;
+
+        // a 16 bit channel reads bytes (Id * 2) and (Id * 2) + 1 of the slice
+        if ( currentServoPCA9685.Is16Bit && ( ( (ChannelId * 2) + 1 ) >= OutputBufferSize ) )
+        {
+            logcon (CN_stars + String (F (" 16 bit data for channel '")) + String (ChannelId + 1) + F ("' is outside of the output buffer. Using 8 bits ") + CN_stars);
+            currentServoPCA9685.Is16Bit = false;
+            response                    = false;
+        }
+
+        if (currentServoPCA9685.Is16Bit)
+        {
+            Has16BitChannels              = true;
+            currentServoPCA9685.DirtyMask = uint32_t (3) << (ChannelId * 2);
+        }
+    }
+
+    DirtyChannels = uint32_t (-1);
 
     /*
      *    uint8_t CurrentServoPCA9685ChanIndex = 0;
@@ -166,6 +207,171 @@ bool c_OutputServoPCA9685::validate ()
     return(response);
 }  // validate
 
+// ----------------------------------------------------------------------------
+/* Convert an input value to PWM ticks using the original scaling rules.
+ *   Only used to build the tick tables. Poll() never calls this.
+ */
+uint16_t c_OutputServoPCA9685::CalculateTicks (ServoPCA9685Channel_t & Channel, uint16_t Value, uint16_t MaxValue)
+{
+    // DEBUG_START;
+
+    uint16_t    MaxScaledValue = MaxValue;
+    uint16_t    MinScaledValue = 0;
+    uint16_t    Final_value    = Value;
+
+    if (Channel.IsReversed)
+    {
+        MinScaledValue = MaxScaledValue;
+        MaxScaledValue = 0;
+    }
+
+    if (Channel.IsScaled)
+    {
+        uint16_t pulse_width = map (
+            Value,
+            MinScaledValue,
+            MaxScaledValue,
+            Channel.MinLevel,
+            Channel.MaxLevel);
+        Final_value = int( ( float(pulse_width) / float(MicroSecondsInASecond) ) * float(UpdateFrequency) * 4096.0 );
+    }
+
+    // DEBUG_END;
+    return(Final_value);
+}  // CalculateTicks
+
+// ----------------------------------------------------------------------------
+/* LED mode: gamma corrected duty cycle over the full 0 - 4096 range.
+ *   The gamma table has 4 fractional bits. With dithering the fraction is
+ *   carried from frame to frame so that a fade through the low end (below
+ *   SERVO_PCA9685_DITHER_MAX_DUTY, where one step is visible) moves in 16
+ *   times finer steps on average. The frame rate is the servo rate so a
+ *   pattern held for long would flicker. A level that has not changed for
+ *   SERVO_PCA9685_DITHER_SETTLE_FRAMES settles on the nearest step and the
+ *   channel stops needing a write every frame.
+ */
+uint16_t c_OutputServoPCA9685::CalculateLedTicks (ServoPCA9685Channel_t & Channel, uint16_t Value, uint8_t ChannelId)
+{
+    // DEBUG_START;
+
+    uint32_t Level;
+
+    if (Channel.Is16Bit)
+    {
+        if (Channel.IsReversed)
+        {
+            Value = 65535 - Value;
+        }
+
+        // interpolate between the 8 bit table entries
+        uint32_t    High  = Value >> 8;
+        uint32_t    Low   = Value & 0xff;
+        uint32_t    Next  = min (High + 1, uint32_t (255) );
+        Level = LedGammaTable[High] + ( ( (LedGammaTable[Next] - LedGammaTable[High]) * Low) >> 8);
+    }
+    else
+    {
+        if (Channel.IsReversed)
+        {
+            Value = 255 - Value;
+        }
+
+        Level = LedGammaTable[Value & 0xff];
+    }
+
+    if (Level != Channel.DitherLevel)
+    {
+        Channel.DitherLevel  = Level;
+        Channel.DitherFrames = 0;
+    }
+    else if (Channel.DitherFrames < SERVO_PCA9685_DITHER_SETTLE_FRAMES)
+    {
+        ++Channel.DitherFrames;
+    }
+
+    uint32_t Duty;
+
+    if ( EnableDither &&
+         (Level & 0x0f) &&
+         ( Level < (SERVO_PCA9685_DITHER_MAX_DUTY << 4) ) &&
+         (Channel.DitherFrames < SERVO_PCA9685_DITHER_SETTLE_FRAMES) )
+    {
+        uint32_t Total = Level + Channel.DitherError;
+        Duty                 = Total >> 4;
+        Channel.DitherError  = Total & 0x0f;
+        DitherChannels      |= (1 << ChannelId);
+    }
+    else
+    {
+        Duty                 = (Level + 0x08) >> 4;
+        Channel.DitherError  = 0;
+        DitherChannels      &= ~(1 << ChannelId);
+    }
+
+    uint16_t Response = uint16_t (Duty);
+
+    if (0 == Duty)
+    {
+        Response = SERVO_PCA9685_FULL_OFF;
+    }
+    else if (Duty >= 4096)
+    {
+        Response = SERVO_PCA9685_FULL_ON;
+    }
+
+    // DEBUG_END;
+    return(Response);
+}  // CalculateLedTicks
+
+// ----------------------------------------------------------------------------
+/* Precompute the value to ticks conversion for each channel.
+ *   8 bit channels get a full table. 16 bit channels use
+ *       ticks = (value * TickSlope + TickOffset) >> 16
+ *   which stays within 1 tick of the two step integer / float conversion
+ *   (see host/ServoPCA9685Test.cpp).
+ */
+void c_OutputServoPCA9685::BuildTickTables ()
+{
+    // DEBUG_START;
+
+    // ticks per microsecond of pulse width
+    double TicksPerUs = double(UpdateFrequency) * 4096.0 / double(MicroSecondsInASecond);
+
+    // LED duty cycle. 4096 (full on) * 16 fits easily
+    for (uint32_t Level = 0; Level < 256; ++Level)
+    {
+        LedGammaTable[Level] = uint32_t ( (pow (double(Level) / 255.0, SERVO_PCA9685_LED_GAMMA) * 4096.0 * 16.0) + 0.5);
+    }
+
+    for (ServoPCA9685Channel_t & currentServoPCA9685 : OutputList)
+    {
+        for (uint32_t Value = 0; Value < 256; ++Value)
+        {
+            currentServoPCA9685.TickTable[Value] = CalculateTicks (currentServoPCA9685, Value, 255);
+        }
+
+        double  Slope  = 1.0;
+        double  Offset = 0.0;
+
+        if (currentServoPCA9685.IsScaled)
+        {
+            Slope  = ( double(currentServoPCA9685.MaxLevel) - double(currentServoPCA9685.MinLevel) ) * TicksPerUs / 65535.0;
+            Offset = double(currentServoPCA9685.MinLevel) * TicksPerUs;
+
+            if (currentServoPCA9685.IsReversed)
+            {
+                Offset += Slope * 65535.0;
+                Slope   = -Slope;
+            }
+        }
+
+        currentServoPCA9685.TickSlope  = int32_t ( (Slope * 65536.0) + ( (Slope < 0) ? -0.5 : 0.5) );
+        currentServoPCA9685.TickOffset = int64_t ( (Offset * 65536.0) + 0.5);
+    }
+
+    // DEBUG_END;
+}  // BuildTickTables
+
 // ----------------------------------------------------------------------------
 /* Process the config
  *
@@ -181,15 +387,18 @@ bool c_OutputServoPCA9685::SetConfig (ArduinoJson::JsonObject & jsonConfig)
 
     do  // once
     {
-        if(!FoundDevice)
-        {
-            break;
-        }
         // extern void PrettyPrint (JsonObject & jsonStuff, String Name);
 
         // PrettyPrint (jsonConfig, String("c_OutputServoPCA9685::SetConfig"));
         setFromJSON (UpdateFrequency, jsonConfig, OM_SERVO_PCA9685_UPDATE_INTERVAL_NAME);
-        pwm->setPWMFreq (UpdateFrequency);
+        setFromJSON (EnableDither, jsonConfig, OM_SERVO_PCA9685_DITHER_NAME);
+
+        // keep the config for a device that is missing. It is applied when the device shows up
+        if (FoundDevice)
+        {
+            pwm->setPWMFreq (UpdateFrequency);
+            EnableAutoIncrement ();
+        }
 
         // do we have a channel configuration array?
         if ( false == jsonConfig.containsKey (OM_SERVO_PCA9685_CHANNELS_NAME) )
@@ -223,6 +432,7 @@ bool c_OutputServoPCA9685::SetConfig (ArduinoJson::JsonObject & jsonConfig)
             setFromJSON (   CurrentOutputChannel->Is16Bit,      JsonChannelData,    OM_SERVO_PCA9685_CHANNEL_16BITS);
             setFromJSON (   CurrentOutputChannel->IsScaled,     JsonChannelData,    OM_SERVO_PCA9685_CHANNEL_SCALED);
             setFromJSON (   CurrentOutputChannel->HomeValue,    JsonChannelData,    OM_SERVO_PCA9685_CHANNEL_HOME);
+            setFromJSON (   CurrentOutputChannel->IsLed,        JsonChannelData,    OM_SERVO_PCA9685_CHANNEL_LED);
 
             // DEBUG_V (String ("ChannelId: ") + String (ChannelId));
             // DEBUG_V (String ("  Enabled: ") + String (CurrentOutputChannel->Enabled));
@@ -246,6 +456,7 @@ void c_OutputServoPCA9685::GetConfig (ArduinoJson::JsonObject & jsonConfig)
     // DEBUG_START;
 
     jsonConfig[OM_SERVO_PCA9685_UPDATE_INTERVAL_NAME] = UpdateFrequency;
+    jsonConfig[OM_SERVO_PCA9685_DITHER_NAME]          = EnableDither;
 
     JsonArray   JsonChannelList = jsonConfig.createNestedArray (OM_SERVO_PCA9685_CHANNELS_NAME);
 
@@ -262,6 +473,7 @@ void c_OutputServoPCA9685::GetConfig (ArduinoJson::JsonObject & jsonConfig)
         JsonChannelData[OM_SERVO_PCA9685_CHANNEL_16BITS]        = currentServoPCA9685.Is16Bit;
         JsonChannelData[OM_SERVO_PCA9685_CHANNEL_SCALED]        = currentServoPCA9685.IsScaled;
         JsonChannelData[OM_SERVO_PCA9685_CHANNEL_HOME]          = currentServoPCA9685.HomeValue;
+        JsonChannelData[OM_SERVO_PCA9685_CHANNEL_LED]           = currentServoPCA9685.IsLed;
 
         // DEBUG_V (String ("ChannelId: ") + String (ChannelId));
         // DEBUG_V (String ("  Enabled: ") + String (currentServoPCA9685.Enabled));
@@ -283,83 +495,529 @@ void c_OutputServoPCA9685::GetDriverName (String & sDriverName)
     sDriverName = CN_Servo_PCA9685;
 }                                                                                                 // GetDriverName
 
+// ----------------------------------------------------------------------------
+void c_OutputServoPCA9685::EnableAutoIncrement ()
+{
+    // DEBUG_START;
+
+    // setPWMFreq normally leaves AI set. Make sure so that the register
+    // address advances through LEDn_ON/OFF during a burst write.
+    Wire.beginTransmission (I2C_Address);
+    Wire.write (PCA9685_MODE1);
+    Wire.endTransmission ();
+
+    if (1 == Wire.requestFrom (I2C_Address, uint8_t (1) ) )
+    {
+        uint8_t Mode1 = Wire.read ();
+
+        if (0 == (Mode1 & MODE1_AI) )
+        {
+            Wire.beginTransmission (I2C_Address);
+            Wire.write (PCA9685_MODE1);
+            Wire.write (Mode1 | MODE1_AI);
+            Wire.endTransmission ();
+        }
+    }
+
+    // DEBUG_END;
+}  // EnableAutoIncrement
+
+// ----------------------------------------------------------------------------
+/* Probe the device and set it up from scratch.
+ *   Used at boot, after a bus recovery and while looking for a device that
+ *   did not answer.
+ */
+bool c_OutputServoPCA9685::InitDevice ()
+{
+    // DEBUG_START;
+
+    bool Response = false;
+
+    do  // once
+    {
+        ++I2CStats.Probes;
+        Wire.beginTransmission (I2C_Address);
+        uint8_t Error = Wire.endTransmission ();
+
+        if (0 != Error)
+        {
+            // DEBUG_V(String("I2C error: ") + String(Error));
+            CountI2CError (Error);
+            FoundDevice = false;
+            break;
+        }
+
+        if (nullptr == pwm)
+        {
+            // DEBUG_V("Allocate PWM");
+            pwm = new Adafruit_PWMServoDriver (I2C_Address, Wire);
+        }
+
+        pwm->begin ();
+        pwm->setPWMFreq (UpdateFrequency);
+        EnableAutoIncrement ();
+
+        FoundDevice = true;
+        Response    = true;
+    } while (false);
+
+    // DEBUG_END;
+    return(Response);
+}  // InitDevice
+
+// ----------------------------------------------------------------------------
+/* Free a bus that a device is holding.
+ *   A slave that lost clocks in the middle of a byte keeps SDA low until it
+ *   has seen the rest of the byte. Clock SCL until SDA is released (at most
+ *   9 clocks) and then send a STOP so that every device is idle again.
+ */
+void c_OutputServoPCA9685::ClearBus ()
+{
+    // DEBUG_START;
+
+    Wire.end ();
+
+    pinMode (DEFAULT_I2C_SDA, INPUT_PULLUP);
+    pinMode (DEFAULT_I2C_SCL, OUTPUT_OPEN_DRAIN);
+    digitalWrite (DEFAULT_I2C_SCL, HIGH);
+    delayMicroseconds (5);
+
+    for (uint8_t Clock = 0; (Clock < SERVO_PCA9685_I2C_CLEAR_CLOCKS) && (LOW == digitalRead (DEFAULT_I2C_SDA) ); ++Clock)
+    {
+        digitalWrite (DEFAULT_I2C_SCL, LOW);
+        delayMicroseconds (5);
+        digitalWrite (DEFAULT_I2C_SCL, HIGH);
+        delayMicroseconds (5);
+    }
+
+    // STOP: SDA goes high while SCL is high
+    digitalWrite (DEFAULT_I2C_SCL, LOW);
+    pinMode (DEFAULT_I2C_SDA, OUTPUT_OPEN_DRAIN);
+    digitalWrite (DEFAULT_I2C_SDA, LOW);
+    delayMicroseconds (5);
+    digitalWrite (DEFAULT_I2C_SCL, HIGH);
+    delayMicroseconds (5);
+    digitalWrite (DEFAULT_I2C_SDA, HIGH);
+    delayMicroseconds (5);
+
+    Wire.begin ( int (DEFAULT_I2C_SDA), int (DEFAULT_I2C_SCL) );
+
+    // DEBUG_END;
+}  // ClearBus
+
+// ----------------------------------------------------------------------------
+/* Get a failed or missing device back.
+ *   After a failed transfer the bus is cleared and the device is set up
+ *   again. A device that answers is sent the whole of its last frame since
+ *   the re-init turned all of its outputs off. Attempts are spaced out so
+ *   that a dead board does not eat the bus time of the others.
+ */
+void c_OutputServoPCA9685::RecoverDevice ()
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        uint32_t Now = millis ();
+
+        if ( (Now - LastRecoveryMs) < (FoundDevice ? SERVO_PCA9685_RECOVERY_HOLDOFF_MS : SERVO_PCA9685_REPROBE_MS) )
+        {
+            break;
+        }
+
+        LastRecoveryMs = Now;
+
+        if (BusFault)
+        {
+            ++I2CStats.Recoveries;
+            ClearBus ();
+        }
+
+        if (!InitDevice ())
+        {
+            break;
+        }
+
+        if (0 != WriteChannelRun (0, OM_SERVO_PCA9685_CHANNEL_LIMIT) )
+        {
+            BusFault = true;
+            break;
+        }
+
+        logcon ( String ( F ("PCA device at address ") ) + String (I2C_Address) + F (" is back online") );
+
+        // the motion and LED state may have moved on while the device was gone
+        BusFault       = false;
+        DirtyChannels  = OM_DIRTY_ALL;
+    } while (false);
+
+    // DEBUG_END;
+}  // RecoverDevice
+
+// ----------------------------------------------------------------------------
+void c_OutputServoPCA9685::CountI2CError (uint8_t Error)
+{
+    // DEBUG_START;
+
+    // Wire error codes: 2 = address NACK, 3 = data NACK, 5 = timeout
+    if ( (2 == Error) || (3 == Error) )
+    {
+        ++I2CStats.Nacks;
+    }
+    else if (5 == Error)
+    {
+        ++I2CStats.Timeouts;
+    }
+    else
+    {
+        ++I2CStats.OtherErrors;
+    }
+
+    // DEBUG_END;
+}  // CountI2CError
+
+// ----------------------------------------------------------------------------
+uint8_t c_OutputServoPCA9685::WriteChannelRun (uint8_t FirstChannel, uint8_t NumChannels)
+{
+    // DEBUG_START;
+
+    uint32_t StartTimeUs = micros ();
+
+    // one transaction for LEDn_ON_L .. LEDm_OFF_H (4 registers per channel)
+    Wire.beginTransmission (I2C_Address);
+    Wire.write ( uint8_t ( PCA9685_LED0_ON_L + (FirstChannel * 4) ) );
+
+    for (uint8_t ChannelId = FirstChannel; ChannelId < (FirstChannel + NumChannels); ++ChannelId)
+    {
+        uint16_t    Ticks  = PwmTicks[ChannelId];
+        uint16_t    OnTime = 0;
+
+        if (SERVO_PCA9685_FULL_ON == Ticks)
+        {
+            OnTime = 4096;
+            Ticks  = 0;
+        }
+
+        Wire.write ( uint8_t (OnTime) );        // ON_L
+        Wire.write ( uint8_t (OnTime >> 8) );   // ON_H
+        Wire.write ( uint8_t (Ticks) );         // OFF_L
+        Wire.write ( uint8_t (Ticks >> 8) );    // OFF_H
+    }
+
+    uint8_t Error = Wire.endTransmission ();
+
+    uint32_t    LatencyUs  = micros () - StartTimeUs;
+    uint32_t    Bytes      = 1 + (uint32_t (NumChannels) * 4);
+    uint32_t    Bucket     = 0;
+    uint32_t    BucketUs   = SERVO_PCA9685_I2C_HISTOGRAM_FIRST_US;
+
+    while ( (LatencyUs >= BucketUs) && (Bucket < (SERVO_PCA9685_I2C_HISTOGRAM_BUCKETS - 1) ) )
+    {
+        ++Bucket;
+        BucketUs <<= 1;
+    }
+
+    ++I2CStats.LatencyHistogram[Bucket];
+    ++I2CStats.Transactions;
+    ++I2CTransactions;
+    I2CStats.Bytes          += Bytes;
+    I2CStats.BytesLastFrame += Bytes;
+
+    if (0 != Error)
+    {
+        CountI2CError (Error);
+    }
+
+    // DEBUG_END;
+    return(Error);
+}  // WriteChannelRun
+
+// ----------------------------------------------------------------------------
+/* Queue a move for the next frame.
+ *   The final value is also written to the output buffer so that the channel
+ *   rests there once the move is done. A new move replaces the one in progress
+ *   and starts from wherever the channel currently is. DurationMs = 0 jumps.
+ */
+void c_OutputServoPCA9685::MoveChannelTo (uint32_t ChannelId, uint16_t TargetValue, uint32_t DurationMs, c_OutputMgr::MotionCurve_t Curve)
+{
+    // DEBUG_START;
+
+    do  // once
+    {
+        if (ChannelId >= OM_SERVO_PCA9685_CHANNEL_LIMIT)
+        {
+            break;
+        }
+
+        if (OutputList[ChannelId].Is16Bit)
+        {
+            if ( ( (ChannelId * 2) + 1 ) < OutputBufferSize )
+            {
+                pOutputBuffer[(ChannelId * 2) + 0] = uint8_t (TargetValue);
+                pOutputBuffer[(ChannelId * 2) + 1] = uint8_t (TargetValue >> 8);
+            }
+        }
+        else if (ChannelId < OutputBufferSize)
+        {
+            pOutputBuffer[ChannelId] = uint8_t (TargetValue);
+        }
+
+        portENTER_CRITICAL (&MotionLock);
+        Motion[ChannelId].PendingTarget     = TargetValue;
+        Motion[ChannelId].PendingDurationUs = DurationMs * 1000;
+        Motion[ChannelId].PendingCurve      = Curve;
+        PendingMoves |= (1 << ChannelId);
+        portEXIT_CRITICAL (&MotionLock);
+    } while (false);
+
+    // DEBUG_END;
+}  // MoveChannelTo
+
+// ----------------------------------------------------------------------------
+void c_OutputServoPCA9685::StartPendingMoves (uint32_t Now)
+{
+    // DEBUG_START;
+
+    portENTER_CRITICAL (&MotionLock);
+
+    for (uint8_t ChannelId = 0; ChannelId < OM_SERVO_PCA9685_CHANNEL_LIMIT; ++ChannelId)
+    {
+        if ( 0 == ( PendingMoves & (1 << ChannelId) ) )
+        {
+            continue;
+        }
+
+        ChannelMotion_t & CurrentMotion = Motion[ChannelId];
+
+        CurrentMotion.StartValue  = CurrentMotion.CurrentValue;
+        CurrentMotion.TargetValue = CurrentMotion.PendingTarget;
+        CurrentMotion.DurationUs  = CurrentMotion.PendingDurationUs;
+        CurrentMotion.Curve       = CurrentMotion.PendingCurve;
+        CurrentMotion.StartTimeUs = Now;
+        MovingChannels           |= (1 << ChannelId);
+    }
+
+    PendingMoves = 0;
+
+    portEXIT_CRITICAL (&MotionLock);
+
+    // DEBUG_END;
+}  // StartPendingMoves
+
+// ----------------------------------------------------------------------------
+uint16_t c_OutputServoPCA9685::UpdateMotion (ChannelMotion_t & CurrentMotion, uint32_t Now)
+{
+    // DEBUG_START;
+
+    uint16_t    Response  = CurrentMotion.TargetValue;
+    uint32_t    ElapsedUs = Now - CurrentMotion.StartTimeUs;
+
+    if (ElapsedUs < CurrentMotion.DurationUs)
+    {
+        // progress through the move in Q16
+        uint32_t Progress = uint32_t ( (uint64_t (ElapsedUs) << 16) / CurrentMotion.DurationUs );
+
+        switch (CurrentMotion.Curve)
+        {
+            case c_OutputMgr::MotionCurveEaseIn:
+            {
+                Progress = (Progress * Progress) >> 16;
+                break;
+            }
+
+            case c_OutputMgr::MotionCurveEaseOut:
+            {
+                uint32_t Remaining = 65536 - Progress;
+                Progress = 65536 - uint32_t ( (uint64_t (Remaining) * Remaining) >> 16);
+                break;
+            }
+
+            case c_OutputMgr::MotionCurveSCurve:
+            {
+                // smoothstep: 3p^2 - 2p^3
+                uint32_t Squared = (Progress * Progress) >> 16;
+                Progress = ( (3 * Squared) - uint32_t ( (uint64_t (2 * Squared) * Progress) >> 16) );
+                break;
+            }
+
+            default:
+            {
+                break;
+            }
+        } // switch
+
+        int32_t Delta = int32_t (CurrentMotion.TargetValue) - int32_t (CurrentMotion.StartValue);
+        Response = uint16_t ( int32_t (CurrentMotion.StartValue) + int32_t ( (int64_t (Delta) * Progress) >> 16) );
+    }
+
+    // DEBUG_END;
+    return(Response);
+}  // UpdateMotion
+
 // ----------------------------------------------------------------------------
 uint32_t c_OutputServoPCA9685::Poll ()
 {
     // DEBUG_START;
 
-    uint8_t OutputDataIndex = 0;
+    uint8_t     OutputDataIndex = 0;
+    uint16_t    ChangedChannels = 0;
 
-    if(FoundDevice)
+    if (ProbeEnabled && (BusFault || !FoundDevice) )
+    {
+        RecoverDevice ();
+    }
+
+    if (FoundDevice && !BusFault)
     {
         ReportNewFrame ();
-        for (ServoPCA9685Channel_t & currentServoPCA9685 : OutputList)
+
+        uint32_t Now = micros ();
+
+        if (PendingMoves)
+        {
+            StartPendingMoves (Now);
+        }
+
+        // only visit the channels whose data changed or that are moving
+        uint16_t ChannelsToCheck = MovingChannels | DitherChannels;
+
+        if (DirtyChannels)
+        {
+            if (false == Has16BitChannels)
+            {
+                ChannelsToCheck |= uint16_t (DirtyChannels);
+            }
+            else
+            {
+                for (uint8_t ChannelId = 0; ChannelId < OM_SERVO_PCA9685_CHANNEL_LIMIT; ++ChannelId)
+                {
+                    if (DirtyChannels & OutputList[ChannelId].DirtyMask)
+                    {
+                        ChannelsToCheck |= (1 << ChannelId);
+                    }
+                }
+            }
+
+            DirtyChannels = 0;
+        }
+
+        ChannelsToCheck &= EnabledChannels;
+
+        while (ChannelsToCheck)
         {
+            OutputDataIndex  = __builtin_ctz (ChannelsToCheck);
+            ChannelsToCheck &= (ChannelsToCheck - 1);
+
+            ServoPCA9685Channel_t & currentServoPCA9685 = OutputList[OutputDataIndex];
             // DEBUG_V (String("OutputDataIndex: ") + String(OutputDataIndex));
-            // DEBUG_V (String ("       Enabled: ") + String (currentServoPCA9685.Enabled));
-            if (currentServoPCA9685.Enabled)
+            uint16_t newOutputValue = pFrameData[OutputDataIndex];
+
+            if (currentServoPCA9685.Is16Bit)
+            {
+                // DEBUG_V ("16 Bit Mode");
+                newOutputValue  = (pFrameData[(OutputDataIndex * 2) + 0] << 0);
+                newOutputValue += (pFrameData[(OutputDataIndex * 2) + 1] << 8);
+            }
+
+            // a move in progress overrides the frame data
+            if ( MovingChannels & (1 << OutputDataIndex) )
             {
-                uint16_t    MaxScaledValue = 255;
-                uint16_t    MinScaledValue = 0;
-                uint16_t    newOutputValue = pOutputBuffer[OutputDataIndex];
+                ChannelMotion_t &   CurrentMotion = Motion[OutputDataIndex];
+                uint16_t            FrameValue    = newOutputValue;
+
+                newOutputValue = UpdateMotion (CurrentMotion, Now);
 
-                if (0 == newOutputValue)
+                // hold the target until the frame data has caught up with it
+                if ( (newOutputValue == CurrentMotion.TargetValue) &&
+                     ( (FrameValue == CurrentMotion.TargetValue) ||
+                       ( (Now - CurrentMotion.StartTimeUs) >= (CurrentMotion.DurationUs + SERVO_PCA9685_MOTION_HOLD_US) ) ) )
                 {
-                    newOutputValue = currentServoPCA9685.HomeValue;
+                    MovingChannels &= ~(1 << OutputDataIndex);
                 }
+            }
+
+            Motion[OutputDataIndex].CurrentValue = newOutputValue;
+
+            if ( (0 == newOutputValue) && !currentServoPCA9685.Is16Bit )
+            {
+                newOutputValue = currentServoPCA9685.HomeValue;
+            }
+
+            // DEBUG_V (String ("newOutputValue: ") + String (newOutputValue));
+            // DEBUG_V (String (" PreviousValue: ") + String (currentServoPCA9685.PreviousValue));
 
-                if (currentServoPCA9685.Is16Bit)
+            if ( (newOutputValue != currentServoPCA9685.PreviousValue) || ( DitherChannels & (1 << OutputDataIndex) ) )
+            {
+                // DEBUG_V (String ("ChannelId: ") + String (OutputDataIndex));
+                // DEBUG_V (String (" MinLevel: ") + String (currentServoPCA9685.MinLevel));
+                // DEBUG_V (String (" MaxLevel: ") + String (currentServoPCA9685.MaxLevel));
+                currentServoPCA9685.PreviousValue = newOutputValue;
+
+                uint16_t Final_value = currentServoPCA9685.TickTable[newOutputValue & 0xff];
+
+                if (currentServoPCA9685.IsLed)
                 {
-                    // DEBUG_V ("16 Bit Mode");
-                    newOutputValue  = (pOutputBuffer[(OutputDataIndex * 2) + 0] << 0);
-                    newOutputValue += (pOutputBuffer[(OutputDataIndex * 2) + 1] << 8);
-                    MaxScaledValue  = uint16_t (-1);
+                    Final_value = CalculateLedTicks (currentServoPCA9685, newOutputValue, OutputDataIndex);
+                }
+                else if (currentServoPCA9685.Is16Bit)
+                {
+                    int64_t Ticks = ( (int64_t (newOutputValue) * currentServoPCA9685.TickSlope) + currentServoPCA9685.TickOffset ) >> 16;
+                    Final_value = uint16_t ( (Ticks < 0) ? 0 : Ticks );
                 }
 
-                // DEBUG_V (String ("newOutputValue: ") + String (newOutputValue));
-                // DEBUG_V (String (" PreviousValue: ") + String (currentServoPCA9685.PreviousValue));
-
-                if (newOutputValue != currentServoPCA9685.PreviousValue)
+                // DEBUG_V (String ("Final_value: ") + String (Final_value));
+                if (Final_value != PwmTicks[OutputDataIndex])
                 {
-                    // DEBUG_V (String ("ChannelId: ") + String (OutputDataIndex));
-                    // DEBUG_V (String (" MinLevel: ") + String (currentServoPCA9685.MinLevel));
-                    // DEBUG_V (String (" MaxLevel: ") + String (currentServoPCA9685.MaxLevel));
-                    currentServoPCA9685.PreviousValue = newOutputValue;
+                    PwmTicks[OutputDataIndex] = Final_value;
+                    ChangedChannels          |= (1 << OutputDataIndex);
+                }
+            }
+        }
+
+        if (0 != ChangedChannels)
+        {
+            uint32_t StartTimeUs = micros ();
+            I2CTransactions         = 0;
+            I2CStats.BytesLastFrame = 0;
 
-                    if (currentServoPCA9685.IsReversed)
+            if ( __builtin_popcount (ChangedChannels) >= (OM_SERVO_PCA9685_CHANNEL_LIMIT / 2) )
+            {
+                // most of the channels changed. Send them all in one burst
+                BusFault = (0 != WriteChannelRun (0, OM_SERVO_PCA9685_CHANNEL_LIMIT) );
+            }
+            else
+            {
+                // send each run of adjacent changed channels in one burst
+                uint8_t ChannelId = 0;
+
+                while ( (ChannelId < OM_SERVO_PCA9685_CHANNEL_LIMIT) && !BusFault)
+                {
+                    if ( 0 == ( ChangedChannels & (1 << ChannelId) ) )
                     {
-                        // DEBUG_V (String("Reverse Lookup"));
-                        MinScaledValue = MaxScaledValue;
-                        MaxScaledValue = 0;
+                        ++ChannelId;
+                        continue;
                     }
 
-                    uint16_t Final_value = newOutputValue;
+                    uint8_t FirstChannel = ChannelId;
 
-                    if (currentServoPCA9685.IsScaled)
+                    while ( (ChannelId < OM_SERVO_PCA9685_CHANNEL_LIMIT) && ( ChangedChannels & (1 << ChannelId) ) )
                     {
-                        // DEBUG_V (String ("Is Scalled"));
-                        // DEBUG_V (String ("newOutputValue: ") + String (newOutputValue));
-                        // DEBUG_V (String ("      MinLevel: ") + String (currentServoPCA9685.MinLevel));
-                        // DEBUG_V (String ("      MaxLevel: ") + String (currentServoPCA9685.MaxLevel));
-                        // DEBUG_V (String ("MinScaledValue: ") + String (MinScaledValue));
-                        // DEBUG_V (String ("MaxScaledValue: ") + String (MaxScaledValue));
-
-                        uint16_t pulse_width = map (
-                            newOutputValue,
-                            MinScaledValue,
-                            MaxScaledValue,
-                            currentServoPCA9685.MinLevel,
-                            currentServoPCA9685.MaxLevel);
-                        Final_value = int( ( float(pulse_width) / float(MicroSecondsInASecond) ) * float(UpdateFrequency) * 4096.0 );
-                        // DEBUG_V (String ("pulse_width: ") + String (pulse_width));
-                        // DEBUG_V (String ("Final_value: ") + String (Final_value));
+                        ++ChannelId;
                     }
 
-                    pwm->setPWM (OutputDataIndex, 0, Final_value);
+                    BusFault = (0 != WriteChannelRun (FirstChannel, ChannelId - FirstChannel) );
                 }
             }
 
-            ++OutputDataIndex;
+            I2CBusyUs    = micros () - StartTimeUs;
+            I2CBusyMaxUs = max (I2CBusyMaxUs, I2CBusyUs);
+            I2CStats.BytesMaxFrame = max (I2CStats.BytesMaxFrame, I2CStats.BytesLastFrame);
+
+            if (BusFault)
+            {
+                // RecoverDevice resends the whole frame
+                logcon ( String ( F ("ERROR: I2C transfer to PCA device at address ") ) + String (I2C_Address) + F (" failed") );
+            }
         }
     }
 
@@ -375,6 +1033,33 @@ void c_OutputServoPCA9685::GetStatus (JsonObject & jsonStatus)
     c_OutputCommon::GetStatus (jsonStatus);
     jsonStatus[F("I2C_Address")] = I2C_Address;
     jsonStatus[CN_en] = FoundDevice;
+    jsonStatus["I2CBusyUs"]       = I2CBusyUs;
+    jsonStatus["I2CBusyMaxUs"]    = I2CBusyMaxUs;
+    jsonStatus["I2CTransactions"] = I2CTransactions;
+
+    JsonObject I2C = jsonStatus.createNestedObject ("I2C");
+    I2C["Transactions"]   = I2CStats.Transactions;
+    I2C["Bytes"]          = I2CStats.Bytes;
+    I2C["BytesPerFrame"]  = I2CStats.BytesLastFrame;
+    I2C["BytesMaxFrame"]  = I2CStats.BytesMaxFrame;
+    I2C["Nacks"]          = I2CStats.Nacks;
+    I2C["Timeouts"]       = I2CStats.Timeouts;
+    I2C["OtherErrors"]    = I2CStats.OtherErrors;
+    I2C["Recoveries"]     = I2CStats.Recoveries;
+    I2C["Probes"]         = I2CStats.Probes;
+    I2C["BusFault"]       = BusFault;
+
+    // LatencyUs[n] counts transactions shorter than LatencyLimitUs[n]. The last bucket has no limit (0)
+    JsonArray   LatencyLimits   = I2C.createNestedArray ("LatencyLimitUs");
+    JsonArray   Latency         = I2C.createNestedArray ("LatencyUs");
+    uint32_t    BucketUs        = SERVO_PCA9685_I2C_HISTOGRAM_FIRST_US;
+
+    for (uint32_t Bucket = 0; Bucket < SERVO_PCA9685_I2C_HISTOGRAM_BUCKETS; ++Bucket)
+    {
+        LatencyLimits.add ( (Bucket < (SERVO_PCA9685_I2C_HISTOGRAM_BUCKETS - 1) ) ? BucketUs : 0);
+        Latency.add (I2CStats.LatencyHistogram[Bucket]);
+        BucketUs <<= 1;
+    }
 
     // DEBUG_END;
 
@@ -38,7 +38,17 @@ typedef struct ServoPCA9685Channel_s
     bool IsReversed        = false;
     bool Is16Bit           = false;
     bool IsScaled          = true;
+    bool IsLed             = false;         // gamma corrected 12 bit duty cycle instead of a servo pulse
     uint8_t HomeValue      = 0;
+    uint8_t DitherError    = 0;             // LED mode: fraction of a duty step carried to the next frame (Q4)
+    uint32_t DitherLevel   = 0;             // LED mode: Q4 level being dithered
+    uint8_t DitherFrames   = 0;             // LED mode: frames DitherLevel has been held
+
+    // derived from the settings above by BuildTickTables ()
+    uint16_t TickTable[256];                // 8 bit value -> LEDn_OFF ticks
+    int32_t TickSlope      = 0;             // 16 bit value -> ticks, Q16
+    int64_t TickOffset     = 0;             // Q16
+    uint32_t DirtyMask     = 0;             // bytes of the buffer slice this channel reads
 } ServoPCA9685Channel_t;
 
 public:
@@ -47,7 +57,8 @@ public:
 c_OutputServoPCA9685 (c_OutputMgr::e_OutputChannelIds   OutputChannelId,
  gpio_num_t                                             outputGpio,
  uart_port_t                                            uart,
- c_OutputMgr::e_OutputType                              outputType);
+ c_OutputMgr::e_OutputType                              outputType,
+ uint8_t                                                I2CAddress);
 virtual~c_OutputServoPCA9685 ();
 
 // functions to be provided by the derived class
@@ -65,6 +76,18 @@ uint32_t GetNumOutputBufferChannelsServiced ()
 {
     return(OutputBufferSize);
 }
+void MoveChannelTo (uint32_t    ChannelId,
+ uint16_t                       TargetValue,
+ uint32_t                       DurationMs,
+ c_OutputMgr::MotionCurve_t     Curve);
+bool HasPendingWork ()
+{
+    return( (0 != (MovingChannels | PendingMoves | DitherChannels) ) || (ProbeEnabled && (BusFault || !FoundDevice) ) );
+}                                                                               ///< a move, LED dithering or a bus recovery is in progress
+uint32_t GetFrameTimeMs ()
+{
+    return( max ( uint32_t (1), uint32_t (float(MilliSecondsInASecond) / UpdateFrequency) ) );
+}                                                                               ///< one frame per servo pulse period
 private:
     #define OM_SERVO_PCA9685_CHANNEL_LIMIT          16
     #define OM_SERVO_PCA9685_UPDATE_INTERVAL_NAME   CN_updateinterval
@@ -78,9 +101,61 @@ private:
     #define OM_SERVO_PCA9685_CHANNEL_16BITS         CN_b16
     #define OM_SERVO_PCA9685_CHANNEL_SCALED         CN_sca
     #define OM_SERVO_PCA9685_CHANNEL_HOME           CN_hv
+    #define OM_SERVO_PCA9685_CHANNEL_LED            CN_led
+    #define OM_SERVO_PCA9685_DITHER_NAME            "dither"
+    #define SERVO_PCA9685_LED_GAMMA                 2.2
+    #define SERVO_PCA9685_DITHER_MAX_DUTY           64              // only dither below this duty cycle. One step is over 1.5% of the level
+    #define SERVO_PCA9685_DITHER_SETTLE_FRAMES      16              // one full Q4 pattern. Then a held level settles on the nearest step
+    #define SERVO_PCA9685_FULL_OFF                  4096            // OFF_H bit 4
+    #define SERVO_PCA9685_FULL_ON                   0xffff          // sent as ON_H bit 4
     #define SERVO_PCA9685_UPDATE_FREQUENCY          50
+    #define SERVO_PCA9685_MOTION_HOLD_US            (1000 * 1000)
+    #define SERVO_PCA9685_RECOVERY_HOLDOFF_MS       250             // between recovery attempts while the device answers
+    #define SERVO_PCA9685_REPROBE_MS                5000            // between probes while the device is missing
+    #define SERVO_PCA9685_I2C_CLEAR_CLOCKS          9
+    #define SERVO_PCA9685_I2C_HISTOGRAM_FIRST_US    100             // upper limit of the first latency bucket. Doubles per bucket
+    #define SERVO_PCA9685_I2C_HISTOGRAM_BUCKETS     8               // the last bucket has no upper limit
+
+// A move in progress on one channel. Start / Pending are written by
+// MoveChannelTo (loop), everything else belongs to Poll (loop or output task).
+struct ChannelMotion_t
+{
+    uint16_t CurrentValue      = 0;             // value sent in the last frame
+    uint16_t StartValue        = 0;
+    uint16_t TargetValue       = 0;
+    uint32_t StartTimeUs       = 0;
+    uint32_t DurationUs        = 0;
+    c_OutputMgr::MotionCurve_t Curve = c_OutputMgr::MotionCurveLinear;
+
+    uint16_t PendingTarget     = 0;
+    uint32_t PendingDurationUs = 0;
+    c_OutputMgr::MotionCurve_t PendingCurve = c_OutputMgr::MotionCurveLinear;
+};
+
+ChannelMotion_t Motion[OM_SERVO_PCA9685_CHANNEL_LIMIT];
+uint16_t MovingChannels   = 0;                  // channels with a move in progress (Poll)
+uint16_t PendingMoves     = 0;                  // channels with a new move request (MotionLock)
+portMUX_TYPE MotionLock   = portMUX_INITIALIZER_UNLOCKED;
+
+void StartPendingMoves (uint32_t Now);
+uint16_t UpdateMotion (ChannelMotion_t &    Motion,
+ uint32_t                                   Now);
 
 bool validate ();
+void BuildTickTables ();
+uint16_t CalculateLedTicks (ServoPCA9685Channel_t & Channel,
+ uint16_t                                           Value,
+ uint8_t                                            ChannelId);
+uint16_t CalculateTicks (ServoPCA9685Channel_t &    Channel,
+ uint16_t                                           Value,
+ uint16_t                                           MaxValue);
+void EnableAutoIncrement ();
+bool InitDevice ();
+void ClearBus ();
+void RecoverDevice ();
+void CountI2CError (uint8_t Error);
+uint8_t WriteChannelRun (uint8_t    FirstChannel,
+ uint8_t                            NumChannels);
 
 // config data
 ServoPCA9685Channel_t OutputList[OM_SERVO_PCA9685_CHANNEL_LIMIT];
@@ -92,5 +167,39 @@ String OutputName;
 uint16_t Num_Channels = OM_SERVO_PCA9685_CHANNEL_LIMIT;
 uint8_t I2C_Address  = PCA9685_I2C_ADDRESS;
 bool FoundDevice  = false;
+uint16_t PwmTicks[OM_SERVO_PCA9685_CHANNEL_LIMIT];  // LEDn_OFF value last sent to each channel
+uint16_t EnabledChannels     = 0;
+bool Has16BitChannels        = false;
+
+// LED mode
+bool EnableDither            = false;       // spread sub-step duty cycles over several frames while a low level changes
+uint16_t DitherChannels      = 0;           // LED channels that need a new duty cycle next frame
+uint32_t LedGammaTable[256];                // 8 bit level -> duty cycle 0 - 4096 in Q4
+
+// I2C statistics for the most recent frame
+uint32_t I2CBusyUs       = 0;
+uint32_t I2CBusyMaxUs    = 0;
+uint32_t I2CTransactions = 0;
+
+// I2C totals since boot. Written by Poll, read by GetStatus
+struct I2CStats_t
+{
+    uint32_t Transactions    = 0;
+    uint32_t Bytes           = 0;
+    uint32_t BytesLastFrame  = 0;
+    uint32_t BytesMaxFrame   = 0;
+    uint32_t Nacks           = 0;           // address or data not acknowledged
+    uint32_t Timeouts        = 0;
+    uint32_t OtherErrors     = 0;
+    uint32_t Recoveries      = 0;           // bus clear + device re-init attempts
+    uint32_t Probes          = 0;
+    uint32_t LatencyHistogram[SERVO_PCA9685_I2C_HISTOGRAM_BUCKETS] = {0};
+};
+I2CStats_t I2CStats;
+
+// bus recovery
+bool ProbeEnabled        = false;           // the bus is set up and the address is usable
+bool BusFault            = false;           // a transfer failed. Recover before sending the next frame
+uint32_t LastRecoveryMs  = 0;
 
 }; // c_OutputServoPCA9685
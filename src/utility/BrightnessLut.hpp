@@ -0,0 +1,53 @@
+#pragma once
+/*
+ * BrightnessLut.hpp - Combined brightness / gamma lookup table
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include <Arduino.h>
+
+// Maps an 8 bit channel value to its output level:
+//      Table[i] = 255 * brightness * (i / 255) ^ gamma
+// The float math is done once when the settings change so that the render
+// path is reduced to a single table lookup per channel.
+class c_BrightnessLut
+{
+public:
+    #define BRIGHTNESS_LUT_MIN_GAMMA        1.0
+    #define BRIGHTNESS_LUT_MAX_GAMMA        3.0
+    #define BRIGHTNESS_LUT_DEFAULT_GAMMA    1.0
+
+    c_BrightnessLut () {Build (1.0, BRIGHTNESS_LUT_DEFAULT_GAMMA);}
+
+    // brightness 0.0 -> 1.0, gamma 1.0 (linear) -> 3.0
+    void Build (float brightness, float gamma)
+    {
+        brightness = constrain (brightness, 0.0F, 1.0F);
+        gamma      = constrain (gamma, float(BRIGHTNESS_LUT_MIN_GAMMA), float(BRIGHTNESS_LUT_MAX_GAMMA));
+
+        for (uint32_t index = 0; index < sizeof (Table); ++index)
+        {
+            float level = powf (float(index) / 255.0F, gamma) * brightness * 255.0F;
+            Table[index] = uint8_t ( min (255.0F, level + 0.5F) );
+        }
+    } // Build
+
+    inline uint8_t operator [] (uint8_t value) const {return(Table[value]);}
+
+private:
+    uint8_t Table[256];
+}; // c_BrightnessLut
@@ -0,0 +1,71 @@
+#pragma once
+/*
+ * FastRandom.hpp - Small seedable pseudo random number generator
+ *
+ * Project: JurasicParkGate
+ * Copyright (c) 2023 Martin Mueller
+ * http://www.MartnMueller2003.com
+ *
+ *  This program is provided free for you to use in any way that you wish,
+ *  subject to the laws and regulations where you are using it.  Due diligence
+ *  is strongly suggested before using this code.  Please give credit where due.
+ *
+ *  The Author makes no warranty of any kind, express or implied, with regard
+ *  to this program or the documentation contained in this document.  The
+ *  Author shall not be liable in any event for incidental or consequential
+ *  damages in connection with, or arising out of, the furnishing, performance
+ *  or use of these programs.
+ *
+ */
+
+#include <Arduino.h>
+
+// xorshift32 generator. Cheap enough to call per pixel per frame and, unlike
+// the Arduino random(), it produces the same sequence for the same seed.
+class c_FastRandom
+{
+public:
+    c_FastRandom (uint32_t seed = 0) {Seed (seed);}
+
+    // a seed of zero would lock the generator at zero, so it is replaced
+    void Seed (uint32_t seed) {State = (0 == seed) ? 0x9E3779B9UL : seed;}
+
+    inline uint32_t Next ()
+    {
+        State ^= State << 13;
+        State ^= State >> 17;
+        State ^= State << 5;
+
+        return(State);
+    } // Next
+
+    // Uniform value in [0, range). Lemire's multiply and shift method: the
+    // division only runs on the rare path that rejects a biased sample.
+    inline uint32_t Below (uint32_t range)
+    {
+        uint64_t    product = uint64_t (Next ()) * range;
+        uint32_t    low     = uint32_t (product);
+
+        if (low < range)
+        {
+            uint32_t threshold = (0 - range) % range;
+
+            while (low < threshold)
+            {
+                product = uint64_t (Next ()) * range;
+                low     = uint32_t (product);
+            }
+        }
+
+        return( uint32_t (product >> 32) );
+    } // Below
+
+    // Uniform value in [min, max). Same contract as Arduino random (min, max).
+    inline int32_t Range (int32_t min, int32_t max)
+    {
+        return( (max <= min) ? min : ( min + int32_t ( Below ( uint32_t (max - min) ) ) ) );
+    } // Range
+
+private:
+    uint32_t State;
+}; // c_FastRandom